@@ -9,6 +9,10 @@ std::string LoggerFactory::log_output_path_;
 std::shared_ptr<spdlog::logger> LoggerFactory::get_logger(
     const std::string& logger_name) {
     constexpr bool ENABLE_DEFAULT_SINK_FOR_OTHER_LOGGERS = true;
+    // ranks may be constructed concurrently, and creating a logger or
+    // attaching sinks to it is not thread-safe
+    static std::mutex logger_mutex;
+    std::lock_guard<std::mutex> lock(logger_mutex);
     auto logger = spdlog::get(logger_name);
     if (logger == nullptr) {
         // logger = spdlog::create_async<spdlog::sinks::stdout_color_sink_mt>(logger_name);
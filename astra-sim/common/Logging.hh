@@ -5,6 +5,7 @@
 #include "spdlog/spdlog.h"
 #include "spdlog_setup/conf.h"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
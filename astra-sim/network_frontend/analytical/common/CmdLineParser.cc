@@ -40,7 +40,10 @@ void CmdLineParser::define_options() noexcept {
         "injection-scale", "Injection scale",
         cxxopts::value<double>()->default_value("1"))(
         "rendezvous-protocol", "Whether to enable rendezvous protocol",
-        cxxopts::value<bool>()->default_value("false"));
+        cxxopts::value<bool>()->default_value("false"))(
+        "startup-threads",
+        "Threads constructing the NPUs at startup (0: one per hardware thread)",
+        cxxopts::value<int>()->default_value("0"));
 }
 
 void CmdLineParser::parse(int argc, char* argv[]) noexcept {
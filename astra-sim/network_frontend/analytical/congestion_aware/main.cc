@@ -4,6 +4,9 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "astra-sim/system/SystemConfig.hh"
+#include "astra-sim/system/ThreadPool.hh"
 #include "common/CmdLineParser.hh"
 #include "congestion_aware/CongestionAwareNetworkApi.hh"
 #include <astra-network-analytical/common/EventQueue.h>
@@ -40,12 +43,18 @@ int main(int argc, char* argv[]) {
         cmd_line_parser.get<std::string>("log-output-path");
     const auto num_queues_per_dim =
         cmd_line_parser.get<int>("num-queues-per-dim");
+    const auto compute_scale = cmd_line_parser.get<double>("compute-scale");
     const auto comm_scale = cmd_line_parser.get<double>("comm-scale");
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol =
         cmd_line_parser.get<bool>("rendezvous-protocol");
+    const auto startup_threads = cmd_line_parser.get<int>("startup-threads");
 
     AstraSim::LoggerFactory::init(logging_configuration);
+    SimProfiler::startup_begin();
+
+    // Parse the system configuration once, shared by all NPUs
+    const auto system_config = SystemConfig::load(system_configuration);
     AstraSim::LoggerFactory::set_output_path(log_output_path);
 
     // Instantiate event queue
@@ -61,6 +70,8 @@ int main(int argc, char* argv[]) {
     const auto npus_count_per_dim = topology->get_npus_count_per_dim();
     const auto dims_count = topology->get_dims_count();
 
+    SimProfiler::startup_phase("configuration");
+
     // Set up Network API
     CongestionAwareNetworkApi::set_event_queue(event_queue);
     CongestionAwareNetworkApi::set_topology(topology);
@@ -70,26 +81,36 @@ int main(int argc, char* argv[]) {
         std::vector<std::unique_ptr<CongestionAwareNetworkApi>>();
     const auto memory_api =
         std::make_unique<AnalyticalRemoteMemory>(remote_memory_configuration);
-    auto systems = std::vector<Sys*>();
 
     auto queues_per_dim = std::vector<int>();
     for (auto i = 0; i < dims_count; i++) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
+    // create networks
     for (int i = 0; i < npus_count; i++) {
-        // create network and system
-        auto network_api = std::make_unique<CongestionAwareNetworkApi>(i);
-        auto* const system =
-            new Sys(i, workload_configuration, comm_group_configuration,
-                    system_configuration, memory_api.get(), network_api.get(),
+        network_apis.push_back(std::make_unique<CongestionAwareNetworkApi>(i));
+    }
+    SimProfiler::startup_phase("network");
+
+    // create systems in parallel; each registers under its own rank
+    auto systems = std::vector<Sys*>(npus_count);
+    {
+        auto pool = ThreadPool(startup_threads);
+        SimProfiler::startup_threads = pool.size();
+        for (int i = 0; i < npus_count; i++) {
+            pool.submit([&, i] {
+                systems[i] = new Sys(
+                    i, workload_configuration, comm_group_configuration,
+                    system_config, memory_api.get(), network_apis[i].get(),
                     npus_count_per_dim, queues_per_dim, injection_scale,
-                    comm_scale, rendezvous_protocol);
-
-        // push back network and system
-        network_apis.push_back(std::move(network_api));
-        systems.push_back(system);
+                    comm_scale, compute_scale, rendezvous_protocol);
+            });
+        }
+        pool.wait();
     }
+    SimProfiler::startup_phase("systems");
+    SimProfiler::report_startup(npus_count);
 
     // Initiate ASTRA-sim simulation
     for (int i = 0; i < npus_count; i++) {
@@ -100,6 +121,7 @@ int main(int argc, char* argv[]) {
     while (!event_queue->finished()) {
         event_queue->proceed();
     }
+    Sys::check_streamed_workloads();
 
     // terminate simulation
     AstraSim::LoggerFactory::shutdown();
@@ -13,6 +13,9 @@ using namespace NetworkAnalyticalCongestionUnaware;
 
 std::shared_ptr<Topology> CongestionUnawareNetworkApi::topology;
 
+std::shared_ptr<RepresentativeRanks>
+    CongestionUnawareNetworkApi::representative_ranks = nullptr;
+
 void CongestionUnawareNetworkApi::set_topology(
     std::shared_ptr<Topology> topology_ptr) noexcept {
     assert(topology_ptr != nullptr);
@@ -27,6 +30,14 @@ void CongestionUnawareNetworkApi::set_topology(
         CongestionUnawareNetworkApi::topology->get_bandwidth_per_dim();
 }
 
+void CongestionUnawareNetworkApi::set_representative_ranks(
+    std::shared_ptr<RepresentativeRanks> representative_ranks_ptr) noexcept {
+    assert(representative_ranks_ptr != nullptr);
+
+    CongestionUnawareNetworkApi::representative_ranks =
+        std::move(representative_ranks_ptr);
+}
+
 CongestionUnawareNetworkApi::CongestionUnawareNetworkApi(
     const int rank) noexcept
     : CommonNetworkApi(rank) {
@@ -41,8 +52,27 @@ int CongestionUnawareNetworkApi::sim_send(void* const buffer,
                                           sim_request* const request,
                                           void (*msg_handler)(void*),
                                           void* const fun_arg) {
-    // query chunk id
     const auto src = sim_comm_get_rank();
+
+    if (representative_ranks != nullptr) {
+        // the send completes after the communication delay, as usual
+        representative_ranks->check_peer(src, dst);
+        const auto send_delay = topology->send(src, dst, count);
+        sim_schedule({NS, static_cast<double>(send_delay)}, msg_handler,
+                     fun_arg);
+
+        // a stand-in peer sends the same message to this rank right now
+        auto recv = RepresentativeRanks::PendingRecv();
+        const auto now = event_queue->get_current_time();
+        if (representative_ranks->on_send(src, count, now, recv)) {
+            const auto recv_delay = topology->send(recv.src, src, count);
+            sim_schedule({NS, static_cast<double>(recv_delay)},
+                         recv.msg_handler, recv.fun_arg);
+        }
+        return 0;
+    }
+
+    // query chunk id
     const auto chunk_id =
         CongestionUnawareNetworkApi::chunk_id_generator.create_send_chunk_id(
             tag, src, dst, count);
@@ -79,3 +109,32 @@ int CongestionUnawareNetworkApi::sim_send(void* const buffer,
     // return
     return 0;
 }
+
+int CongestionUnawareNetworkApi::sim_recv(void* const buffer,
+                                          const uint64_t count,
+                                          const int type,
+                                          const int src,
+                                          const int tag,
+                                          sim_request* const request,
+                                          void (*msg_handler)(void*),
+                                          void* const fun_arg) {
+    if (representative_ranks == nullptr) {
+        return CommonNetworkApi::sim_recv(buffer, count, type, src, tag,
+                                          request, msg_handler, fun_arg);
+    }
+
+    // the message arrives once the stand-in peer's matching send (issued
+    // together with this rank's own send) has crossed the network
+    const auto dst = sim_comm_get_rank();
+    representative_ranks->check_peer(dst, src);
+    const auto recv = RepresentativeRanks::PendingRecv{src, msg_handler,
+                                                       fun_arg};
+    auto send_time = EventTime();
+    if (representative_ranks->on_recv(dst, count, recv, send_time)) {
+        const auto now = event_queue->get_current_time();
+        const auto arrival = send_time + topology->send(src, dst, count);
+        const auto delta = arrival > now ? arrival - now : 0;
+        sim_schedule({NS, static_cast<double>(delta)}, msg_handler, fun_arg);
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/RepresentativeRanks.hh"
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/workload/GraphStore.hh"
+#include "astra-sim/workload/TextWorkload.hh"
+#include "extern/graph_frontend/chakra/src/third_party/utils/protoio.hh"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <json/json.hpp>
+#include <map>
+#include <numeric>
+#include <set>
+#include <tuple>
+
+using namespace AstraSimAnalyticalCongestionUnaware;
+using json = nlohmann::json;
+
+namespace {
+
+int int_attr(const ChakraProtoMsg::AttributeProto& attr) {
+    return attr.has_int32_val() ? attr.int32_val()
+                                : static_cast<int>(attr.int64_val());
+}
+
+// Widen the tile so that every rank of a MeshXY group of 'node' sits at
+// the same coordinates within it. MeshXY collectives without a group span
+// the whole mesh.
+void widen_tile(const ChakraProtoMsg::Node& node,
+                const int mesh_rows,
+                const int mesh_cols,
+                int& tile_x,
+                int& tile_y) {
+    if (node.type() != ChakraProtoMsg::COMM_COLL_NODE) {
+        return;
+    }
+    auto group_x = 0;
+    auto group_y = 0;
+    for (const auto& attr : node.attr()) {
+        if (attr.name() == "group_x") {
+            group_x = int_attr(attr);
+        } else if (attr.name() == "group_y") {
+            group_y = int_attr(attr);
+        }
+    }
+    if (group_x <= 0 || group_y <= 0) {
+        group_x = mesh_rows;
+        group_y = mesh_cols;
+    }
+    tile_x = std::lcm(tile_x, group_x);
+    tile_y = std::lcm(tile_y, group_y);
+}
+
+}  // namespace
+
+RepresentativeRanks::RepresentativeRanks(
+    const std::string& workload_configuration,
+    const std::string& comm_group_configuration,
+    const int npus_count,
+    const std::string& tile,
+    const bool meshxy) {
+    assert(npus_count > 0);
+
+    // tile of the logical mesh, laid out as MeshTopology does
+    auto tile_x = 1;
+    auto tile_y = 1;
+    if (!tile.empty() &&
+        (std::sscanf(tile.c_str(), "%dx%d", &tile_x, &tile_y) != 2 ||
+         tile_x <= 0 || tile_y <= 0)) {
+        AstraSim::LoggerFactory::get_logger("network::representative")
+            ->critical("invalid representative tile: {}", tile);
+        exit(EXIT_FAILURE);
+    }
+    auto mesh_rows = static_cast<int>(std::floor(std::sqrt(npus_count)));
+    mesh_rows = std::max(mesh_rows, 1);
+    const auto mesh_cols = (npus_count + mesh_rows - 1) / mesh_rows;
+
+    // communicator groups each rank belongs to, as (id, size)
+    auto groups = std::vector<std::vector<std::pair<int, int>>>(npus_count);
+    if (comm_group_configuration.find("empty") == std::string::npos) {
+        auto file = std::ifstream(comm_group_configuration);
+        auto j = json();
+        file >> j;
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            const auto group_id = std::stoi(it.key());
+            const auto group_size = static_cast<int>(it.value().size());
+            for (const int rank : it.value()) {
+                groups[rank].emplace_back(group_id, group_size);
+            }
+        }
+    }
+
+    // text workloads run the same graph on every rank, up to the
+    // all-to-all traffic of each rank
+    auto text_workload = std::shared_ptr<const AstraSim::TextWorkload>();
+    if (AstraSim::TextWorkload::is_text_workload(workload_configuration)) {
+        text_workload =
+            AstraSim::TextWorkload::get_shared(workload_configuration);
+    }
+    auto rank_ets = std::vector<std::pair<uint64_t, uint64_t>>(npus_count);
+    for (auto rank = 0; rank < npus_count; rank++) {
+        rank_ets[rank] =
+            text_workload != nullptr
+                ? std::make_pair(text_workload->rank_digest(rank),
+                                 static_cast<uint64_t>(0))
+                : AstraSim::GraphStore::hash_file(
+                      workload_configuration + "." + std::to_string(rank) +
+                      ".et");
+    }
+
+    // without a tile given, MeshXY collectives set it to their groups, as
+    // ranks behave differently depending on their position in a group
+    if (tile.empty() && meshxy) {
+        if (text_workload != nullptr) {
+            const auto& graph = *text_workload->graph;
+            for (uint32_t i = 0; i < graph.num_nodes(); i++) {
+                widen_tile(graph.parse_node(i), mesh_rows, mesh_cols, tile_x,
+                           tile_y);
+            }
+        } else {
+            auto scanned = std::set<std::pair<uint64_t, uint64_t>>();
+            for (auto rank = 0; rank < npus_count; rank++) {
+                if (!scanned.insert(rank_ets[rank]).second) {
+                    continue;
+                }
+                auto et = ProtoInputStream(workload_configuration + "." +
+                                           std::to_string(rank) + ".et");
+                auto global_metadata = ChakraProtoMsg::GlobalMetadata();
+                et.read(global_metadata);
+                auto node = ChakraProtoMsg::Node();
+                while (et.read(node)) {
+                    widen_tile(node, mesh_rows, mesh_cols, tile_x, tile_y);
+                }
+            }
+        }
+        AstraSim::LoggerFactory::get_logger("network::representative")
+            ->info("representative tile of the MeshXY groups: {}x{}", tile_x,
+                   tile_y);
+    }
+
+    using ClassKey = std::tuple<uint64_t, uint64_t,
+                                std::vector<std::pair<int, int>>, int, int>;
+    auto class_ids = std::map<ClassKey, int>();
+    class_of.resize(npus_count);
+    for (auto rank = 0; rank < npus_count; rank++) {
+        const auto [et_hash, et_size] = rank_ets[rank];
+        const auto tile_i = (rank / mesh_cols) % tile_x;
+        const auto tile_j = (rank % mesh_cols) % tile_y;
+        auto key = ClassKey(et_hash, et_size, groups[rank], tile_i, tile_j);
+
+        const auto [it, inserted] =
+            class_ids.try_emplace(std::move(key), classes.size());
+        if (inserted) {
+            classes.emplace_back();
+        }
+        class_of[rank] = it->second;
+        classes[it->second].push_back(rank);
+    }
+
+    AstraSim::LoggerFactory::get_logger("network::representative")
+        ->info("{} ranks in {} equivalence classes", npus_count,
+               classes.size());
+}
+
+const std::vector<std::vector<int>>& RepresentativeRanks::get_classes()
+    const noexcept {
+    return classes;
+}
+
+void RepresentativeRanks::check_peer(const int rank, const int peer) noexcept {
+    assert(0 <= rank && rank < class_of.size());
+    assert(0 <= peer && peer < class_of.size());
+
+    const auto rank_class = class_of[rank];
+    const auto peer_class = class_of[peer];
+    if (rank_class == peer_class) {
+        return;
+    }
+    const auto inserted =
+        warned_class_pairs
+            .emplace(std::min(rank_class, peer_class),
+                     std::max(rank_class, peer_class))
+            .second;
+    if (inserted) {
+        AstraSim::LoggerFactory::get_logger("network::representative")
+            ->warn("rank {} (class of rank {}) exchanges messages with rank {} "
+                   "(class of rank {}); their classes are assumed to behave "
+                   "identically",
+                   rank, classes[rank_class].front(), peer,
+                   classes[peer_class].front());
+    }
+}
+
+bool RepresentativeRanks::on_send(const int rank,
+                                  const uint64_t count,
+                                  const EventTime now,
+                                  PendingRecv& matched) {
+    auto& channel = channels[rank][count];
+    if (channel.recvs.empty()) {
+        channel.send_times.push_back(now);
+        return false;
+    }
+    matched = channel.recvs.front();
+    channel.recvs.pop_front();
+    return true;
+}
+
+bool RepresentativeRanks::on_recv(const int rank,
+                                  const uint64_t count,
+                                  const PendingRecv& recv,
+                                  EventTime& send_time) {
+    auto& channel = channels[rank][count];
+    if (channel.send_times.empty()) {
+        channel.recvs.push_back(recv);
+        return false;
+    }
+    send_time = channel.send_times.front();
+    channel.send_times.pop_front();
+    return true;
+}
+
+void RepresentativeRanks::report_divergence() const noexcept {
+    auto logger =
+        AstraSim::LoggerFactory::get_logger("network::representative");
+    for (const auto& [rank, rank_channels] : channels) {
+        for (const auto& [count, channel] : rank_channels) {
+            if (!channel.recvs.empty()) {
+                logger->warn("class of rank {} diverged: {} receives of {} "
+                             "bytes have no matching send",
+                             rank, channel.recvs.size(), count);
+            }
+            if (!channel.send_times.empty()) {
+                logger->warn("class of rank {} diverged: {} sends of {} bytes "
+                             "have no matching receive",
+                             rank, channel.send_times.size(), count);
+            }
+        }
+    }
+}
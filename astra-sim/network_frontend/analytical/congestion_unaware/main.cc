@@ -4,6 +4,9 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "astra-sim/system/SystemConfig.hh"
+#include "astra-sim/system/ThreadPool.hh"
 #include "common/CmdLineParser.hh"
 #include "congestion_unaware/CongestionUnawareNetworkApi.hh"
 #include <astra-network-analytical/common/EventQueue.h>
@@ -21,6 +24,14 @@ using namespace NetworkAnalyticalCongestionUnaware;
 int main(int argc, char* argv[]) {
     // Parse command line arguments
     auto cmd_line_parser = CmdLineParser(argv[0]);
+    cmd_line_parser.get_options().add_options()(
+        "representative-ranks",
+        "Simulate one representative rank per class of equivalent ranks",
+        cxxopts::value<bool>()->default_value("false"))(
+        "representative-tile",
+        "Tile of the logical mesh ranks are classified in ([x]x[y]); "
+        "defaults to the groups of the MeshXY collectives",
+        cxxopts::value<std::string>()->default_value(""));
     cmd_line_parser.parse(argc, argv);
 
     // Get command line arguments
@@ -38,12 +49,22 @@ int main(int argc, char* argv[]) {
         cmd_line_parser.get<std::string>("logging-configuration");
     const auto num_queues_per_dim =
         cmd_line_parser.get<int>("num-queues-per-dim");
+    const auto compute_scale = cmd_line_parser.get<double>("compute-scale");
     const auto comm_scale = cmd_line_parser.get<double>("comm-scale");
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol =
         cmd_line_parser.get<bool>("rendezvous-protocol");
+    const auto startup_threads = cmd_line_parser.get<int>("startup-threads");
+    const auto representative_mode =
+        cmd_line_parser.get<bool>("representative-ranks");
+    const auto representative_tile =
+        cmd_line_parser.get<std::string>("representative-tile");
 
     AstraSim::LoggerFactory::init(logging_configuration);
+    SimProfiler::startup_begin();
+
+    // Parse the system configuration once, shared by all NPUs
+    const auto system_config = SystemConfig::load(system_configuration);
 
     // Instantiate event queue
     const auto event_queue = std::make_shared<EventQueue>();
@@ -57,6 +78,8 @@ int main(int argc, char* argv[]) {
     const auto npus_count_per_dim = topology->get_npus_count_per_dim();
     const auto dims_count = topology->get_dims_count();
 
+    SimProfiler::startup_phase("configuration");
+
     // Set up Network API
     CongestionUnawareNetworkApi::set_event_queue(event_queue);
     CongestionUnawareNetworkApi::set_topology(topology);
@@ -66,36 +89,74 @@ int main(int argc, char* argv[]) {
         std::vector<std::unique_ptr<CongestionUnawareNetworkApi>>();
     const auto memory_api =
         std::make_unique<AnalyticalRemoteMemory>(remote_memory_configuration);
-    auto systems = std::vector<Sys*>();
 
     auto queues_per_dim = std::vector<int>();
     for (auto i = 0; i < dims_count; i++) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
-    for (int i = 0; i < npus_count; i++) {
-        // create network and system
-        auto network_api = std::make_unique<CongestionUnawareNetworkApi>(i);
-        auto* const system =
-            new Sys(i, workload_configuration, comm_group_configuration,
-                    system_configuration, memory_api.get(), network_api.get(),
-                    npus_count_per_dim, queues_per_dim, injection_scale,
-                    comm_scale, rendezvous_protocol);
-
-        // push back network and system
-        network_apis.push_back(std::move(network_api));
-        systems.push_back(system);
+    // In representative mode only the first rank of every class of
+    // equivalent ranks is simulated, and it reports for its whole class.
+    auto representative_ranks = std::shared_ptr<RepresentativeRanks>();
+    auto simulated_ranks = std::vector<std::vector<int>>();
+    if (representative_mode) {
+        representative_ranks = std::make_shared<RepresentativeRanks>(
+            workload_configuration, comm_group_configuration, npus_count,
+            representative_tile, system_config->uses_meshxy());
+        CongestionUnawareNetworkApi::set_representative_ranks(
+            representative_ranks);
+        simulated_ranks = representative_ranks->get_classes();
+    } else {
+        for (int i = 0; i < npus_count; i++) {
+            simulated_ranks.push_back({i});
+        }
     }
 
+    // create networks
+    for (const auto& ranks : simulated_ranks) {
+        network_apis.push_back(
+            std::make_unique<CongestionUnawareNetworkApi>(ranks.front()));
+    }
+    SimProfiler::startup_phase("network");
+
+    // create systems in parallel; each registers under its own rank
+    auto systems = std::vector<Sys*>(simulated_ranks.size());
+    {
+        auto pool = ThreadPool(startup_threads);
+        SimProfiler::startup_threads = pool.size();
+        for (size_t k = 0; k < simulated_ranks.size(); k++) {
+            pool.submit([&, k] {
+                const auto& ranks = simulated_ranks[k];
+                auto* const system = new Sys(
+                    ranks.front(), workload_configuration,
+                    comm_group_configuration, system_config, memory_api.get(),
+                    network_apis[k].get(), npus_count_per_dim, queues_per_dim,
+                    injection_scale, comm_scale, compute_scale,
+                    rendezvous_protocol);
+                system->represented_ranks.assign(ranks.begin() + 1,
+                                                 ranks.end());
+                systems[k] = system;
+            });
+        }
+        pool.wait();
+    }
+    SimProfiler::startup_phase("systems");
+    SimProfiler::report_startup(npus_count);
+
     // Initiate simulation
-    for (int i = 0; i < npus_count; i++) {
-        systems[i]->workload->fire();
+    for (auto* const system : systems) {
+        system->workload->fire();
     }
 
     // run simulation
     while (!event_queue->finished()) {
         event_queue->proceed();
     }
+    Sys::check_streamed_workloads();
+
+    if (representative_ranks != nullptr) {
+        representative_ranks->report_divergence();
+    }
 
     // terminate simulation
     AstraSim::LoggerFactory::shutdown();
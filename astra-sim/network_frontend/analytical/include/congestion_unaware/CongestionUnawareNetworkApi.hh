@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/CommonNetworkApi.hh"
+#include "congestion_unaware/RepresentativeRanks.hh"
 #include <astra-network-analytical/common/Type.h>
 #include <astra-network-analytical/congestion_unaware/Topology.h>
 #include <vector>
@@ -30,6 +31,14 @@ class CongestionUnawareNetworkApi final : public CommonNetworkApi {
      */
     static void set_topology(std::shared_ptr<Topology> topology_ptr) noexcept;
 
+    /**
+     * Simulate only class representatives; their peers are stood in for.
+     *
+     * @param representative_ranks_ptr equivalence classes of the ranks
+     */
+    static void set_representative_ranks(
+        std::shared_ptr<RepresentativeRanks> representative_ranks_ptr) noexcept;
+
     /**
      * Constructor.
      *
@@ -49,9 +58,24 @@ class CongestionUnawareNetworkApi final : public CommonNetworkApi {
                  void (*msg_handler)(void* fun_arg),
                  void* fun_arg) override;
 
+    /**
+     * Implement sim_recv of AstraNetworkAPI.
+     */
+    int sim_recv(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int src,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+
   private:
     /// topology
     static std::shared_ptr<Topology> topology;
+
+    /// equivalence classes, set in representative mode only
+    static std::shared_ptr<RepresentativeRanks> representative_ranks;
 };
 
 }  // namespace AstraSimAnalyticalCongestionUnaware
@@ -0,0 +1,121 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <astra-network-analytical/common/Type.h>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace AstraSimAnalyticalCongestionUnaware {
+
+/**
+ * RepresentativeRanks groups SPMD ranks into equivalence classes and lets
+ * one representative per class stand in for the whole class.
+ *
+ * Two ranks are equivalent if they run byte-identical ETs, belong to
+ * communicator groups of the same ids and sizes, and sit at the same
+ * coordinates within a tile of the logical mesh (MeshXY collectives
+ * behave differently depending on the position inside their group).
+ *
+ * Peers of a representative are not simulated. In the congestion-unaware
+ * backend every rank of a symmetric run sends the same messages at the
+ * same time, so the k-th message of a given size that a representative
+ * receives is assumed to leave its source when the representative sends
+ * its own k-th message of that size. Messages are matched by size and
+ * order, not by tag, because some collectives fold the sender rank into
+ * the tag.
+ */
+class RepresentativeRanks {
+  public:
+    /// receive of a representative waiting for its stand-in send
+    struct PendingRecv {
+        int src;
+        void (*msg_handler)(void*);
+        void* fun_arg;
+    };
+
+    /**
+     * Classify all ranks.
+     *
+     * @param workload_configuration prefix of the per-rank ET files or a
+     *        text workload
+     * @param comm_group_configuration communicator group file or "empty"
+     * @param npus_count number of ranks
+     * @param tile tile of the logical mesh as "<x>x<y>", or empty to use
+     *        the groups of the MeshXY collectives in the workload
+     * @param meshxy whether collectives are implemented by MeshXY
+     */
+    RepresentativeRanks(const std::string& workload_configuration,
+                        const std::string& comm_group_configuration,
+                        int npus_count,
+                        const std::string& tile,
+                        bool meshxy);
+
+    /**
+     * Classes of equivalent ranks in ascending order of their first rank.
+     * The first rank of each class is its representative.
+     */
+    [[nodiscard]] const std::vector<std::vector<int>>& get_classes()
+        const noexcept;
+
+    /**
+     * Record a message between two ranks, warning once per pair of classes
+     * when they differ, as their behavior is then only assumed to match.
+     */
+    void check_peer(int rank, int peer) noexcept;
+
+    /**
+     * A representative sent a message of 'count' bytes at 'now'. If a
+     * receive of the same size is pending, it is matched and returned.
+     *
+     * @return whether a pending receive was matched into 'matched'
+     */
+    bool on_send(int rank, uint64_t count, EventTime now, PendingRecv& matched);
+
+    /**
+     * A representative posted a receive of 'count' bytes. If the matching
+     * stand-in send already happened, its time is returned in 'send_time'.
+     * Otherwise the receive is kept pending.
+     */
+    bool on_recv(int rank,
+                 uint64_t count,
+                 const PendingRecv& recv,
+                 EventTime& send_time);
+
+    /**
+     * Warn about messages that found no counterpart, i.e. classes whose
+     * peers did not behave like their representative.
+     */
+    void report_divergence() const noexcept;
+
+  private:
+    struct StandInChannel {
+        std::deque<EventTime> send_times;
+        std::deque<PendingRecv> recvs;
+    };
+
+    /// rank -> class index
+    std::vector<int> class_of;
+
+    /// classes of ranks, the first rank being the representative
+    std::vector<std::vector<int>> classes;
+
+    /// per representative, per message size
+    std::unordered_map<int, std::unordered_map<uint64_t, StandInChannel>>
+        channels;
+
+    /// pairs of classes that already exchanged messages
+    std::set<std::pair<int, int>> warned_class_pairs;
+};
+
+}  // namespace AstraSimAnalyticalCongestionUnaware
@@ -5,6 +5,9 @@ LICENSE file in the root directory of this source tree.
 
 #include "HTSimNetworkApi.hh"
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "astra-sim/system/SystemConfig.hh"
+#include "astra-sim/system/ThreadPool.hh"
 #include "common/CmdLineParser.hh"
 #include "HTSimSession.hh"
 #include <astra-network-analytical/common/EventQueue.h>
@@ -32,12 +35,18 @@ int main(int argc, char* argv[]) {
     const auto network_configuration = cmd_line_parser.get<std::string>("network-configuration");
     const auto logging_configuration = cmd_line_parser.get<std::string>("logging-configuration");
     const auto num_queues_per_dim = cmd_line_parser.get<int>("num-queues-per-dim");
+    const auto compute_scale = cmd_line_parser.get<double>("compute-scale");
     const auto comm_scale = cmd_line_parser.get<double>("comm-scale");
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol = cmd_line_parser.get<bool>("rendezvous-protocol");
+    const auto startup_threads = cmd_line_parser.get<int>("startup-threads");
     const auto proto = cmd_line_parser.get<HTSimProto>("htsim-proto");
 
     AstraSim::LoggerFactory::init(logging_configuration);
+    SimProfiler::startup_begin();
+
+    // Parse the system configuration once, shared by all NPUs
+    const auto system_config = SystemConfig::load(system_configuration);
 
     // Generate topology
     const auto network_parser = NetworkParser(network_configuration);
@@ -48,6 +57,8 @@ int main(int argc, char* argv[]) {
     const auto npus_count_per_dim = topology->get_npus_count_per_dim();
     const auto dims_count = topology->get_dims_count();
 
+    SimProfiler::startup_phase("configuration");
+
     // Set up Network API
     HTSimNetworkApi::set_topology(topology);
     auto completion_tracker = std::make_shared<CompletionTracker>(npus_count);
@@ -57,25 +68,35 @@ int main(int argc, char* argv[]) {
     auto network_apis = std::vector<std::unique_ptr<HTSimNetworkApi>>();
     const auto memory_api =
         std::make_unique<Analytical::AnalyticalRemoteMemory>(remote_memory_configuration);
-    auto systems = std::vector<Sys*>();
 
     auto queues_per_dim = std::vector<int>();
     for (auto i = 0; i < dims_count; i++) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
+    // create networks
     for (int i = 0; i < npus_count; i++) {
-        // create network and system
-        auto network_api = std::make_unique<HTSimNetworkApi>(i);
-        auto* const system =
-            new Sys(i, workload_configuration, comm_group_configuration, system_configuration,
-                    memory_api.get(), network_api.get(), npus_count_per_dim, queues_per_dim,
-                    injection_scale, comm_scale, rendezvous_protocol);
-
-        // push back network and system
-        network_apis.push_back(std::move(network_api));
-        systems.push_back(system);
+        network_apis.push_back(std::make_unique<HTSimNetworkApi>(i));
+    }
+    SimProfiler::startup_phase("network");
+
+    // create systems in parallel; each registers under its own rank
+    auto systems = std::vector<Sys*>(npus_count);
+    {
+        auto pool = ThreadPool(startup_threads);
+        SimProfiler::startup_threads = pool.size();
+        for (int i = 0; i < npus_count; i++) {
+            pool.submit([&, i] {
+                systems[i] = new Sys(i, workload_configuration, comm_group_configuration,
+                                     system_config, memory_api.get(), network_apis[i].get(),
+                                     npus_count_per_dim, queues_per_dim, injection_scale,
+                                     comm_scale, compute_scale, rendezvous_protocol);
+            });
+        }
+        pool.wait();
     }
+    SimProfiler::startup_phase("systems");
+    SimProfiler::report_startup(npus_count);
 
     // Get HTSim opts
     int htsim_argc = 0;
@@ -105,6 +126,7 @@ int main(int argc, char* argv[]) {
 
     // run HTSim
     ht.run(&HTSimNetworkApi::htsim_info);
+    Sys::check_streamed_workloads();
 
     // check if terminated properly
     if (!completion_tracker.get()->all_finished()) {
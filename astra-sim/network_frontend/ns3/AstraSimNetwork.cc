@@ -1,5 +1,7 @@
 #include "astra-sim/common/AstraNetworkAPI.hh"
+#include "astra-sim/system/SimProfiler.hh"
 #include "astra-sim/system/Sys.hh"
+#include "astra-sim/system/SystemConfig.hh"
 #include "extern/remote_memory_backend/analytical/AnalyticalRemoteMemory.hh"
 #include <json/json.hpp>
 
@@ -194,6 +196,7 @@ string comm_group_configuration = "empty";
 string logical_topology_configuration;
 string logging_configuration = "empty";
 int num_queues_per_dim = 1;
+double compute_scale = 1;
 double comm_scale = 1;
 double injection_scale = 1;
 bool rendezvous_protocol = false;
@@ -255,6 +258,7 @@ void parse_args(int argc, char* argv[]) {
 
     cmd.AddValue("num-queues-per-dim", "Number of queues per each dimension",
                  num_queues_per_dim);
+    cmd.AddValue("compute-scale", "Compute scale", compute_scale);
     cmd.AddValue("comm-scale", "Communication scale", comm_scale);
     cmd.AddValue("injection-scale", "Injection scale", injection_scale);
     cmd.AddValue("rendezvous-protocol", "Whether to enable rendezvous protocol",
@@ -272,6 +276,7 @@ int main(int argc, char* argv[]) {
     // Read network config and find logical dims.
     parse_args(argc, argv);
     AstraSim::LoggerFactory::init(logging_configuration);
+    AstraSim::SimProfiler::startup_begin();
     read_logical_topo_config(logical_topology_configuration, logical_dims);
 
     // Setup network & System layer.
@@ -280,14 +285,19 @@ int main(int argc, char* argv[]) {
     Analytical::AnalyticalRemoteMemory* mem =
         new Analytical::AnalyticalRemoteMemory(memory_configuration);
     NS3BackendCompletionTracker* completion_tracker = new NS3BackendCompletionTracker(num_npus);
+    // Parse the system configuration once, shared by all NPUs
+    const auto system_config =
+        AstraSim::SystemConfig::load(system_configuration);
 
     for (int npu_id = 0; npu_id < num_npus; npu_id++) {
         networks[npu_id] = new ASTRASimNetwork(npu_id, completion_tracker);
         systems[npu_id] = new AstraSim::Sys(
             npu_id, workload_configuration, comm_group_configuration,
-            system_configuration, mem, networks[npu_id], logical_dims,
-            queues_per_dim, injection_scale, comm_scale, rendezvous_protocol);
+            system_config, mem, networks[npu_id], logical_dims,
+            queues_per_dim, injection_scale, comm_scale, compute_scale,
+            rendezvous_protocol);
     }
+    AstraSim::SimProfiler::report_startup(num_npus);
 
     // Initialize ns3 simulation.
     if (auto ok = setup_ns3_simulation(network_configuration); ok == -1) {
@@ -302,5 +312,6 @@ int main(int argc, char* argv[]) {
 
     // Run the simulation by triggering the ns3 event queue.
     Simulator::Run();
+    AstraSim::Sys::check_streamed_workloads();
     return 0;
 }
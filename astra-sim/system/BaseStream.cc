@@ -6,12 +6,13 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/BaseStream.hh"
 
 #include "astra-sim/system/StreamBaseline.hh"
+#include "astra-sim/system/StreamRegistry.hh"
 
 using namespace AstraSim;
 
-std::map<int, int> BaseStream::synchronizer;
-std::map<int, int> BaseStream::ready_counter;
-std::map<int, std::list<BaseStream*>> BaseStream::suspended_streams;
+BaseStream::~BaseStream() {
+    StreamRegistry::release(registry_slot);
+}
 
 void BaseStream::changeState(StreamState state) {
     this->state = state;
@@ -24,12 +25,8 @@ BaseStream::BaseStream(int stream_id,
     this->owner = owner;
     this->initialized = false;
     this->phases_to_go = phases_to_go;
-    if (synchronizer.find(stream_id) != synchronizer.end()) {
-        synchronizer[stream_id]++;
-    } else {
-        synchronizer[stream_id] = 1;
-        ready_counter[stream_id] = 0;
-    }
+    this->registry_slot =
+        StreamRegistry::acquire(stream_id, Sys::num_sys);
     for (auto& vn : phases_to_go) {
         if (vn.algorithm != nullptr) {
             vn.init(this);
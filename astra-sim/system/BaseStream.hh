@@ -13,6 +13,7 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/CollectivePhase.hh"
 #include "astra-sim/system/Common.hh"
 #include "astra-sim/system/DataSet.hh"
+#include "astra-sim/system/StreamQueue.hh"
 #include "astra-sim/system/StreamStat.hh"
 #include "astra-sim/system/Sys.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/LogicalTopology.hh"
@@ -25,16 +26,16 @@ class BaseStream : public Callable, public StreamStat {
     BaseStream(int stream_id,
                Sys* owner,
                std::list<CollectivePhase> phases_to_go);
-    virtual ~BaseStream() = default;
+    virtual ~BaseStream();
 
     void changeState(StreamState state);
     virtual void consume(RecvPacketEventHandlerData* message) = 0;
     virtual void init() = 0;
 
-    static std::map<int, int> synchronizer;
-    static std::map<int, int> ready_counter;
-    static std::map<int, std::list<BaseStream*>> suspended_streams;
     int stream_id;
+    // dense StreamRegistry slot shared by the streams of all ranks with
+    // this stream_id
+    int registry_slot;
     int total_packets_sent;
     SchedulingPolicy preferred_scheduling;
     std::list<CollectivePhase> phases_to_go;
@@ -50,6 +51,7 @@ class BaseStream : public Callable, public StreamStat {
     int priority;
     StreamState state;
     bool initialized;
+    StreamQueueEntry queue_entry;
 
     Tick last_phase_change;
 
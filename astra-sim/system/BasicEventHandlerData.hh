@@ -8,11 +8,14 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/CallData.hh"
 #include "astra-sim/system/Common.hh"
+#include "astra-sim/system/ObjectPool.hh"
 
 namespace AstraSim {
 
 class BasicEventHandlerData : public CallData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(BasicEventHandlerData)
+
     BasicEventHandlerData();
     BasicEventHandlerData(int sys_id, EventType event);
 
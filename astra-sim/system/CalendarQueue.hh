@@ -0,0 +1,124 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __CALENDAR_QUEUE_HH__
+#define __CALENDAR_QUEUE_HH__
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "astra-sim/common/Common.hh"
+
+namespace AstraSim {
+
+// All items scheduled for one tick, kept contiguously in insertion order.
+// 'head' is the next item to hand out; items appended while the tick is
+// being drained are handed out by the same drain.
+template <typename T>
+struct TickBucket {
+    Tick tick = 0;
+    uint64_t head = 0;
+    std::vector<T> items;
+
+    bool pop(T& item) {
+        if (head < items.size()) {
+            item = items[head++];
+            return true;
+        }
+        return false;
+    }
+
+    void reset() {
+        // keep the capacity so that steady-state traffic does not allocate
+        items.clear();
+        head = 0;
+    }
+};
+
+// Calendar queue keyed by a monotone Tick. Every tick within
+// [now, now + num_buckets) owns one bucket (tick % num_buckets); ticks
+// beyond that horizon, or ticks whose bucket is still held by another
+// tick, are kept in an ordered overflow map. Items of one tick are always
+// returned in insertion order.
+template <typename T>
+class CalendarQueue {
+  public:
+    explicit CalendarQueue(uint64_t num_buckets = 256) {
+        uint64_t size = 1;
+        while (size < num_buckets) {
+            size <<= 1;
+        }
+        buckets.resize(size);
+        mask = size - 1;
+    }
+
+    // Stores 'item' for 'tick' (tick >= now). Returns true if 'item' is the
+    // first item pending for 'tick'.
+    bool push(Tick now, Tick tick, const T& item) {
+        if (tick - now < buckets.size()) {
+            TickBucket<T>& bucket = buckets[tick & mask];
+            if (bucket.items.empty()) {
+                bucket.tick = tick;
+                bucket.items.push_back(item);
+                return overflow.empty() ||
+                       overflow.find(tick) == overflow.end();
+            }
+            if (bucket.tick == tick) {
+                bucket.items.push_back(item);
+                return false;
+            }
+        }
+        auto [it, inserted] = overflow.try_emplace(tick);
+        it->second.items.push_back(item);
+        return inserted && !in_bucket(tick);
+    }
+
+    // Hands out the next item of 'tick'. Overflowed items were stored before
+    // any bucketed item of the same tick, so they go first. Returns false
+    // once 'tick' is drained, and releases the tick.
+    bool pop(Tick tick, T& item) {
+        if (!overflow.empty()) {
+            auto it = overflow.find(tick);
+            if (it != overflow.end()) {
+                if (it->second.pop(item)) {
+                    return true;
+                }
+                overflow.erase(it);
+            }
+        }
+        TickBucket<T>& bucket = buckets[tick & mask];
+        if (bucket.tick != tick || bucket.items.empty()) {
+            return false;
+        }
+        if (bucket.pop(item)) {
+            return true;
+        }
+        bucket.reset();
+        return false;
+    }
+
+    uint64_t num_buckets() const {
+        return buckets.size();
+    }
+
+    uint64_t num_overflowed_ticks() const {
+        return overflow.size();
+    }
+
+  private:
+    bool in_bucket(Tick tick) const {
+        const TickBucket<T>& bucket = buckets[tick & mask];
+        return !bucket.items.empty() && bucket.tick == tick;
+    }
+
+    std::vector<TickBucket<T>> buckets;
+    uint64_t mask;
+    std::map<Tick, TickBucket<T>> overflow;
+};
+
+}  // namespace AstraSim
+
+#endif /* __CALENDAR_QUEUE_HH__ */
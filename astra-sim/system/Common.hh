@@ -7,7 +7,10 @@ LICENSE file in the root directory of this source tree.
 #define __COMMON_HH__
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace AstraSim {
 
@@ -49,6 +52,14 @@ enum class ComType {
     All_Reduce_All_to_All
 };
 
+// the (peer, bytes) an NPU sends to and receives from in an all-to-all;
+// built once per collective and shared, read-only, by all of its chunks
+// and phases
+struct AllToAllMatrix {
+    std::vector<std::pair<int, int>> send;
+    std::vector<std::pair<int, int>> recv;
+};
+
 enum class CollectiveOptimization { Baseline = 0, LocalBWAware };
 
 enum class CollectiveImplType {
@@ -127,7 +138,8 @@ enum class EventType {
     CollectiveCommunicationFinished,
     CompFinished,
     MemLoadFinished,
-    MemStoreFinished
+    MemStoreFinished,
+    CallTickWheel
 };
 
 class CloneInterface {
@@ -8,6 +8,7 @@ LICENSE file in the root directory of this source tree.
 #include <algorithm>
 
 #include "astra-sim/system/CollectivePlan.hh"
+#include "astra-sim/system/StreamRegistry.hh"
 #include "astra-sim/system/Sys.hh"
 
 using namespace AstraSim;
@@ -18,6 +19,7 @@ CommunicatorGroup::CommunicatorGroup(int id,
     set_id(id);
     this->involved_NPUs = involved_NPUs;
     this->generator = generator;
+    StreamRegistry::set_participants(id, involved_NPUs.size());
     std::sort(involved_NPUs.begin(), involved_NPUs.end());
 }
 
@@ -31,7 +33,7 @@ CommunicatorGroup::~CommunicatorGroup() {
 void CommunicatorGroup::set_id(int id) {
     assert(id > 0);
     this->id = id;
-    this->num_streams = id * 1000000;
+    this->num_streams = id * STREAM_ID_NAMESPACE_SIZE;
 }
 
 CollectivePlan* CommunicatorGroup::get_collective_plan(ComType comm_type) {
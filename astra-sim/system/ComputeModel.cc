@@ -0,0 +1,358 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/ComputeModel.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "extern/graph_frontend/chakra/schema/protobuf/et_def.pb.h"
+#include <json/json.hpp>
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+namespace {
+
+void table_panic(const string& path, const string& msg) {
+    LoggerFactory::get_logger("system")
+        ->critical("kernel table {}: {}", path, msg);
+    exit(EXIT_FAILURE);
+}
+
+void rules_panic(const string& path, const string& msg) {
+    LoggerFactory::get_logger("system")
+        ->critical("compute scale rules {}: {}", path, msg);
+    exit(EXIT_FAILURE);
+}
+
+string trim(const string& s) {
+    const auto begin = s.find_first_not_of(" \t\r");
+    if (begin == string::npos) {
+        return "";
+    }
+    const auto end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+vector<string> split_csv_line(const string& line) {
+    vector<string> fields;
+    stringstream ss(line);
+    string field;
+    while (getline(ss, field, ',')) {
+        fields.push_back(trim(field));
+    }
+    return fields;
+}
+
+}  // namespace
+
+shared_ptr<const KernelTable> KernelTable::load(const string& path) {
+    ifstream file(path);
+    if (!file) {
+        table_panic(path, "cannot be opened");
+    }
+    auto table = make_shared<KernelTable>();
+    const bool is_json =
+        path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (is_json) {
+        try {
+            json j;
+            file >> j;
+            const json& rows = j.is_object() ? j.at("kernels") : j;
+            for (const auto& row : rows) {
+                table->add(row.at("op").get<string>(),
+                           {row.at("num_ops").get<uint64_t>(),
+                            row.at("tensor_size").get<uint64_t>(),
+                            row.at("runtime_ns").get<double>()});
+            }
+        } catch (const json::exception& e) {
+            table_panic(path, e.what());
+        }
+    } else {
+        string line;
+        if (!getline(file, line)) {
+            table_panic(path, "is empty");
+        }
+        const auto header = split_csv_line(line);
+        auto column = [&](const string& name) {
+            auto it = find(header.begin(), header.end(), name);
+            if (it == header.end()) {
+                table_panic(path, "missing column " + name);
+            }
+            return static_cast<size_t>(it - header.begin());
+        };
+        const size_t op = column("op");
+        const size_t num_ops = column("num_ops");
+        const size_t tensor_size = column("tensor_size");
+        const size_t runtime_ns = column("runtime_ns");
+        while (getline(file, line)) {
+            if (trim(line).empty() || line[0] == '#') {
+                continue;
+            }
+            const auto fields = split_csv_line(line);
+            if (fields.size() < header.size()) {
+                table_panic(path, "malformed row: " + line);
+            }
+            try {
+                table->add(fields[op], {stoull(fields[num_ops]),
+                                        stoull(fields[tensor_size]),
+                                        stod(fields[runtime_ns])});
+            } catch (const invalid_argument&) {
+                table_panic(path, "malformed row: " + line);
+            } catch (const out_of_range&) {
+                table_panic(path, "out of range value in row: " + line);
+            }
+        }
+    }
+    table->sort_points();
+    return table;
+}
+
+void KernelTable::add(const string& op, const Point& point) {
+    if (point.runtime_ns <= 0) {
+        return;
+    }
+    auto& points = ops[op];
+    if (point.num_ops > 0) {
+        points.compute.push_back(point);
+    } else if (point.tensor_size > 0) {
+        points.memory.push_back(point);
+    }
+}
+
+void KernelTable::sort_points() {
+    for (auto& op : ops) {
+        sort(op.second.compute.begin(), op.second.compute.end(),
+             [](const Point& a, const Point& b) {
+                 return make_pair(a.num_ops, a.tensor_size) <
+                        make_pair(b.num_ops, b.tensor_size);
+             });
+        sort(op.second.memory.begin(), op.second.memory.end(),
+             [](const Point& a, const Point& b) {
+                 return make_pair(a.tensor_size, a.num_ops) <
+                        make_pair(b.tensor_size, b.num_ops);
+             });
+    }
+}
+
+bool KernelTable::lookup(const string& op,
+                         uint64_t num_ops,
+                         uint64_t tensor_size,
+                         double& runtime_ns) const {
+    if (num_ops > 0) {
+        const auto* points = rows(op, &OpPoints::compute);
+        if (points == nullptr) {
+            return false;
+        }
+        runtime_ns = interpolate(*points, &Point::num_ops, &Point::tensor_size,
+                                 num_ops, tensor_size);
+        return true;
+    }
+    if (tensor_size > 0) {
+        const auto* points = rows(op, &OpPoints::memory);
+        if (points == nullptr) {
+            return false;
+        }
+        runtime_ns = interpolate(*points, &Point::tensor_size, &Point::num_ops,
+                                 tensor_size, num_ops);
+        return true;
+    }
+    return false;
+}
+
+const vector<KernelTable::Point>* KernelTable::rows(
+    const string& op, vector<Point> OpPoints::*kind) const {
+    for (const auto& name : {op, string("*")}) {
+        auto it = ops.find(name);
+        if (it != ops.end() && !(it->second.*kind).empty()) {
+            return &(it->second.*kind);
+        }
+    }
+    return nullptr;
+}
+
+double KernelTable::interpolate(const vector<Point>& points,
+                                uint64_t Point::*axis,
+                                uint64_t Point::*other,
+                                uint64_t x,
+                                uint64_t y) {
+    // of the points in [first, last) (all of the same size along 'axis'),
+    // the one closest to 'y' along the other dimension
+    auto closest = [&](vector<Point>::const_iterator first,
+                       vector<Point>::const_iterator last) {
+        const double log_y = log1p(static_cast<double>(y));
+        auto best = first;
+        for (auto p = first; p != last; ++p) {
+            if (fabs(log1p(static_cast<double>((*p).*other)) - log_y) <
+                fabs(log1p(static_cast<double>((*best).*other)) - log_y)) {
+                best = p;
+            }
+        }
+        return *best;
+    };
+    auto rate = [&](const Point& p) {
+        return static_cast<double>(p.*axis) / p.runtime_ns;
+    };
+
+    const auto upper = lower_bound(
+        points.begin(), points.end(), x,
+        [&](const Point& p, uint64_t value) { return p.*axis < value; });
+    if (upper == points.begin() && (*upper).*axis != x) {
+        // smaller than measured: no faster than the smallest kernel
+        auto smallest_last = upper;
+        while (smallest_last != points.end() &&
+               (*smallest_last).*axis == (*upper).*axis) {
+            ++smallest_last;
+        }
+        return closest(upper, smallest_last).runtime_ns;
+    }
+    if (upper != points.end() && (*upper).*axis == x) {
+        auto exact_last = upper;
+        while (exact_last != points.end() && (*exact_last).*axis == x) {
+            ++exact_last;
+        }
+        return closest(upper, exact_last).runtime_ns;
+    }
+    auto lower_last = upper;
+    auto lower_first = upper - 1;
+    while (lower_first != points.begin() &&
+           (*(lower_first - 1)).*axis == (*lower_first).*axis) {
+        --lower_first;
+    }
+    const Point lo = closest(lower_first, lower_last);
+    if (upper == points.end()) {
+        // larger than measured: at the rate of the largest kernel
+        return static_cast<double>(x) / rate(lo);
+    }
+    auto upper_last = upper;
+    while (upper_last != points.end() && (*upper_last).*axis == (*upper).*axis) {
+        ++upper_last;
+    }
+    const Point hi = closest(upper, upper_last);
+    const double t = (log(static_cast<double>(x)) - log(lo.*axis)) /
+                     (log(static_cast<double>(hi.*axis)) - log(lo.*axis));
+    const double log_rate = log(rate(lo)) + t * (log(rate(hi)) - log(rate(lo)));
+    return static_cast<double>(x) / exp(log_rate);
+}
+
+shared_ptr<const ComputeScaleRules> ComputeScaleRules::load(
+    const string& path) {
+    ifstream file(path);
+    if (!file) {
+        rules_panic(path, "cannot be opened");
+    }
+    auto rules = make_shared<ComputeScaleRules>();
+    try {
+        json j;
+        file >> j;
+        if (j.contains("node-types")) {
+            for (const auto& entry : j["node-types"].items()) {
+                ChakraProtoMsg::NodeType node_type;
+                if (!ChakraProtoMsg::NodeType_Parse(entry.key(), &node_type)) {
+                    rules_panic(path, "unknown node type " + entry.key());
+                }
+                rules->node_type_scales[node_type] =
+                    entry.value().get<double>();
+            }
+        }
+        if (j.contains("names")) {
+            for (const auto& rule : j["names"]) {
+                rules->name_rules.push_back(
+                    {regex(rule.at("regex").get<string>(),
+                           regex::ECMAScript | regex::optimize),
+                     rule.at("scale").get<double>()});
+            }
+        }
+    } catch (const json::exception& e) {
+        rules_panic(path, e.what());
+    } catch (const regex_error& e) {
+        rules_panic(path, e.what());
+    }
+    return rules;
+}
+
+int ComputeScaleRules::match(const string& name) const {
+    for (size_t i = 0; i < name_rules.size(); i++) {
+        if (regex_search(name, name_rules[i].pattern)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+double ComputeScaleRules::node_type_scale(int node_type) const {
+    auto it = node_type_scales.find(node_type);
+    return it == node_type_scales.end() ? 1.0 : it->second;
+}
+
+ComputeModel::ComputeModel(shared_ptr<const KernelTable> table,
+                           shared_ptr<const ComputeScaleRules> rules,
+                           double compute_scale)
+    : table(move(table)), rules(move(rules)), compute_scale(compute_scale) {}
+
+bool ComputeModel::get_runtime(const string& op,
+                               uint64_t num_ops,
+                               uint64_t tensor_size,
+                               uint64_t& runtime_ns) {
+    if (table == nullptr) {
+        return false;
+    }
+    ++SimProfiler::compute_model_lookups;
+    Signature signature = {op, num_ops, tensor_size};
+    auto it = memo.find(signature);
+    if (it != memo.end()) {
+        ++SimProfiler::compute_model_memo_hits;
+    } else {
+        double runtime = 0;
+        uint64_t memoized = UINT64_MAX;
+        if (table->lookup(op, num_ops, tensor_size, runtime)) {
+            memoized = max<uint64_t>(1, static_cast<uint64_t>(llround(runtime)));
+        }
+        it = memo.emplace(move(signature), memoized).first;
+    }
+    if (it->second == UINT64_MAX) {
+        ++SimProfiler::compute_model_fallbacks;
+        return false;
+    }
+    runtime_ns = it->second;
+    return true;
+}
+
+uint64_t ComputeModel::scale(const string& name,
+                              int node_type,
+                              uint64_t runtime_ns) {
+    double factor = compute_scale;
+    if (rules != nullptr) {
+        auto it = name_rule_memo.find(name);
+        if (it == name_rule_memo.end()) {
+            ++SimProfiler::compute_scale_name_matches;
+            it = name_rule_memo.emplace(name, rules->match(name)).first;
+        }
+        factor *= it->second >= 0 ? rules->name_scale(it->second)
+                                  : rules->node_type_scale(node_type);
+    }
+    if (factor == 1.0) {
+        return runtime_ns;
+    }
+    return max<uint64_t>(
+        1, static_cast<uint64_t>(llround(runtime_ns * factor)));
+}
+
+size_t ComputeModel::SignatureHash::operator()(
+    const Signature& signature) const {
+    size_t hash = std::hash<string>()(signature.op);
+    hash ^= std::hash<uint64_t>()(signature.num_ops) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint64_t>()(signature.tensor_size) +
+            0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __COMPUTE_MODEL_HH__
+#define __COMPUTE_MODEL_HH__
+
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AstraSim {
+
+// Measured kernel durations, keyed by op and shape (num_ops, tensor_size).
+// Loaded once from a CSV file with the header
+//     op,num_ops,tensor_size,runtime_ns
+// or from a JSON file holding a list of such objects (or {"kernels": list}),
+// and shared read-only by every Sys. Rows of op "*" apply to ops the table
+// has no compute (or no memory) rows for.
+class KernelTable {
+  public:
+    static std::shared_ptr<const KernelTable> load(const std::string& path);
+
+    // Duration in ns of 'op' with the given shape, interpolated between the
+    // measured points. False if neither 'op' nor "*" has rows of its kind.
+    //
+    // Compute ops (num_ops > 0) interpolate the achieved FLOP rate over
+    // num_ops, and memory ops the achieved bandwidth over tensor_size, both
+    // geometrically between the two closest measured sizes; among rows of
+    // the same size the one with the closest other dimension is used.
+    // Smaller ops than measured take as long as the smallest measured one,
+    // larger ops run at the rate of the largest.
+    bool lookup(const std::string& op,
+                uint64_t num_ops,
+                uint64_t tensor_size,
+                double& runtime_ns) const;
+
+  private:
+    struct Point {
+        uint64_t num_ops;
+        uint64_t tensor_size;
+        double runtime_ns;
+    };
+    struct OpPoints {
+        // sorted by (num_ops, tensor_size) and (tensor_size, num_ops)
+        std::vector<Point> compute;
+        std::vector<Point> memory;
+    };
+
+    // the rows of 'op' of one kind, or else those of "*"; null if neither
+    const std::vector<Point>* rows(const std::string& op,
+                                   std::vector<Point> OpPoints::*kind) const;
+    void add(const std::string& op, const Point& point);
+    void sort_points();
+    static double interpolate(const std::vector<Point>& points,
+                              uint64_t Point::*axis,
+                              uint64_t Point::*other,
+                              uint64_t x,
+                              uint64_t y);
+
+    std::unordered_map<std::string, OpPoints> ops;
+};
+
+// Per-node factors of the compute durations, loaded from a JSON file of the
+// form
+//     {"node-types": {"COMP_NODE": 0.5},
+//      "names": [{"regex": "gemm|conv", "scale": 0.25}]}
+// where node types are Chakra NodeType names and name rules apply in
+// order, the first rule whose regex matches the node name (anywhere)
+// winning over the node type. Shared read-only by every Sys.
+class ComputeScaleRules {
+  public:
+    static std::shared_ptr<const ComputeScaleRules> load(
+        const std::string& path);
+
+    // index of the first name rule matching 'name', -1 if none does
+    int match(const std::string& name) const;
+    double name_scale(int rule) const {
+        return name_rules[rule].scale;
+    }
+    // factor of nodes of 'node_type' that no name rule matches
+    double node_type_scale(int node_type) const;
+
+  private:
+    struct NameRule {
+        std::regex pattern;
+        double scale;
+    };
+
+    std::vector<NameRule> name_rules;
+    std::unordered_map<int, double> node_type_scales;
+};
+
+// Compute durations of one Sys: the kernel table lookup, and the scaling
+// stage applied to every duration the workload layer computes itself.
+// Both are memoized per node signature since the same kernels recur across
+// layers and iterations.
+class ComputeModel {
+  public:
+    // any of 'table' and 'rules' may be null
+    ComputeModel(std::shared_ptr<const KernelTable> table,
+                 std::shared_ptr<const ComputeScaleRules> rules,
+                 double compute_scale);
+
+    // Duration in ns of a compute node; false if there is no table or it
+    // does not model the node, in which case the caller falls back to the
+    // roofline or the ET.
+    bool get_runtime(const std::string& op,
+                     uint64_t num_ops,
+                     uint64_t tensor_size,
+                     uint64_t& runtime_ns);
+
+    // 'runtime_ns' scaled by the global compute scale and the factor of
+    // the node's name or type
+    uint64_t scale(const std::string& name,
+                   int node_type,
+                   uint64_t runtime_ns);
+
+  private:
+    struct Signature {
+        std::string op;
+        uint64_t num_ops;
+        uint64_t tensor_size;
+        bool operator==(const Signature& other) const {
+            return num_ops == other.num_ops &&
+                   tensor_size == other.tensor_size && op == other.op;
+        }
+    };
+    struct SignatureHash {
+        size_t operator()(const Signature& signature) const;
+    };
+
+    std::shared_ptr<const KernelTable> table;
+    std::shared_ptr<const ComputeScaleRules> rules;
+    double compute_scale;
+    // signature -> duration in ns, or UINT64_MAX if not modeled
+    std::unordered_map<Signature, uint64_t, SignatureHash> memo;
+    // node name -> index of the name rule matching it, -1 if none
+    std::unordered_map<std::string, int> name_rule_memo;
+};
+
+}  // namespace AstraSim
+
+#endif /* __COMPUTE_MODEL_HH__ */
@@ -10,10 +10,8 @@ LICENSE file in the root directory of this source tree.
 
 using namespace AstraSim;
 
-int DataSet::id_auto_increment = 0;
-
 DataSet::DataSet(int total_streams) {
-    this->my_id = id_auto_increment++;
+    this->my_id = -1;
     this->total_streams = total_streams;
     this->finished_streams = 0;
     this->finished = false;
@@ -21,7 +21,7 @@ class DataSet : public Callable, public StreamStat {
     void call(EventType event, CallData* data);
     bool is_finished();
 
-    static int id_auto_increment;
+    // assigned by the layer that is notified when the DataSet finishes
     int my_id;
     int total_streams;
     int finished_streams;
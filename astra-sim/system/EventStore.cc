@@ -0,0 +1,58 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/EventStore.hh"
+
+#include "astra-sim/common/Logging.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+EventStoreType EventStore::parse_type(const string& type_str) {
+    if (type_str == "map") {
+        return EventStoreType::Map;
+    } else if (type_str == "calendar") {
+        return EventStoreType::Calendar;
+    }
+    LoggerFactory::get_logger("system")->critical(
+        "unknown value for event-queue in sys input file: {}", type_str);
+    exit(1);
+}
+
+EventStore* EventStore::create(EventStoreType type, uint64_t num_buckets) {
+    if (type == EventStoreType::Calendar) {
+        return new CalendarEventStore(num_buckets);
+    }
+    return new MapEventStore();
+}
+
+bool MapEventStore::push(Tick now, Tick tick, const SysEvent& event) {
+    auto [it, inserted] = ticks.try_emplace(tick);
+    it->second.items.push_back(event);
+    return inserted;
+}
+
+bool MapEventStore::pop(Tick tick, SysEvent& event) {
+    auto it = ticks.find(tick);
+    if (it == ticks.end()) {
+        return false;
+    }
+    if (it->second.pop(event)) {
+        return true;
+    }
+    ticks.erase(it);
+    return false;
+}
+
+CalendarEventStore::CalendarEventStore(uint64_t num_buckets)
+    : queue(num_buckets) {}
+
+bool CalendarEventStore::push(Tick now, Tick tick, const SysEvent& event) {
+    return queue.push(now, tick, event);
+}
+
+bool CalendarEventStore::pop(Tick tick, SysEvent& event) {
+    return queue.pop(tick, event);
+}
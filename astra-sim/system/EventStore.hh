@@ -0,0 +1,68 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __EVENT_STORE_HH__
+#define __EVENT_STORE_HH__
+
+#include <map>
+#include <string>
+
+#include "astra-sim/system/CalendarQueue.hh"
+#include "astra-sim/system/CallData.hh"
+#include "astra-sim/system/Callable.hh"
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+struct SysEvent {
+    Callable* callable;
+    EventType event;
+    CallData* data;
+};
+
+enum class EventStoreType { Map = 0, Calendar };
+
+// Per-Sys storage of pending system-layer events, grouped by tick.
+class EventStore {
+  public:
+    virtual ~EventStore() = default;
+
+    // Stores 'event' for 'tick' (tick >= now). Returns true if it is the
+    // first event pending for 'tick', i.e. the backend has to be woken up.
+    virtual bool push(Tick now, Tick tick, const SysEvent& event) = 0;
+
+    // Hands out the pending events of 'tick' in insertion order, including
+    // the ones pushed while the tick is being drained. Returns false once
+    // the tick is drained.
+    virtual bool pop(Tick tick, SysEvent& event) = 0;
+
+    static EventStoreType parse_type(const std::string& type_str);
+    static EventStore* create(EventStoreType type, uint64_t num_buckets);
+};
+
+// Ordered map of ticks (the original event queue layout).
+class MapEventStore : public EventStore {
+  public:
+    bool push(Tick now, Tick tick, const SysEvent& event) override;
+    bool pop(Tick tick, SysEvent& event) override;
+
+  private:
+    std::map<Tick, TickBucket<SysEvent>> ticks;
+};
+
+// Calendar queue with one contiguous bucket per tick.
+class CalendarEventStore : public EventStore {
+  public:
+    explicit CalendarEventStore(uint64_t num_buckets);
+    bool push(Tick now, Tick tick, const SysEvent& event) override;
+    bool pop(Tick tick, SysEvent& event) override;
+
+  private:
+    CalendarQueue<SysEvent> queue;
+};
+
+}  // namespace AstraSim
+
+#endif /* __EVENT_STORE_HH__ */
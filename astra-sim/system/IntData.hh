@@ -6,10 +6,15 @@ LICENSE file in the root directory of this source tree.
 #ifndef __INT_DATA_HH__
 #define __INT_DATA_HH__
 
+#include "astra-sim/system/CallData.hh"
+#include "astra-sim/system/ObjectPool.hh"
+
 namespace AstraSim {
 
 class IntData : public CallData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(IntData)
+
     IntData(int d) {
         data = d;
     }
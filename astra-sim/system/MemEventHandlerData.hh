@@ -7,6 +7,7 @@ LICENSE file in the root directory of this source tree.
 #define __MEM_EVENT_HANDLER_DATA_HH__
 
 #include "astra-sim/system/BasicEventHandlerData.hh"
+#include "astra-sim/system/ObjectPool.hh"
 
 namespace AstraSim {
 
@@ -15,6 +16,8 @@ class WorkloadLayerHandlerData;
 
 class MemEventHandlerData : public BasicEventHandlerData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(MemEventHandlerData)
+
     MemEventHandlerData();
     Workload* workload;
     WorkloadLayerHandlerData* wlhd;
@@ -0,0 +1,40 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/ObjectPool.hh"
+
+#include <mutex>
+
+#include "astra-sim/common/Logging.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+ObjectPoolStats::ObjectPoolStats(const char* name)
+    : name(name), allocations(0), releases(0), slabs(0) {}
+
+vector<ObjectPoolStats*>& ObjectPoolRegistry::pools() {
+    static vector<ObjectPoolStats*> registered_pools;
+    return registered_pools;
+}
+
+ObjectPoolStats* ObjectPoolRegistry::add(const char* name) {
+    static mutex registry_mutex;
+    lock_guard<mutex> lock(registry_mutex);
+    auto* pool = new ObjectPoolStats(name);
+    pools().push_back(pool);
+    return pool;
+}
+
+void ObjectPoolRegistry::report() {
+    auto logger = LoggerFactory::get_logger("system::profile");
+    for (auto pool : pools()) {
+        uint64_t allocations = pool->allocations.load();
+        uint64_t releases = pool->releases.load();
+        logger->info("pool {}: {} allocations, {} releases, {} live, {} slabs",
+                     pool->name, allocations, releases, allocations - releases,
+                     pool->slabs.load());
+    }
+}
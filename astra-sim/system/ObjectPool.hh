@@ -0,0 +1,121 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __OBJECT_POOL_HH__
+#define __OBJECT_POOL_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace AstraSim {
+
+// Allocation counters of one pooled type.
+class ObjectPoolStats {
+  public:
+    explicit ObjectPoolStats(const char* name);
+
+    const char* name;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> releases;
+    std::atomic<uint64_t> slabs;
+};
+
+class ObjectPoolRegistry {
+  public:
+    static ObjectPoolStats* add(const char* name);
+    static void report();
+
+  private:
+    static std::vector<ObjectPoolStats*>& pools();
+};
+
+// Fixed-size object pool for T. Objects are carved out of slabs of
+// SlabObjects slots and recycled through a thread-local free list. Slabs
+// are kept for the lifetime of the process: a slot may be released by
+// another thread than the one that allocated it.
+template <typename T, std::size_t SlabObjects = 256>
+class ObjectPool {
+  public:
+    static void* allocate(std::size_t size, const char* name) {
+        // classes deriving from a pooled class without being pooled
+        // themselves inherit its operator new
+        if (size != sizeof(T)) {
+            return ::operator new(size);
+        }
+        FreeList& list = free_list();
+        if (list.head == nullptr) {
+            refill(list, name);
+        }
+        Slot* slot = list.head;
+        list.head = slot->next;
+        stats(name).allocations.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    static void release(void* ptr, std::size_t size, const char* name) {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (size != sizeof(T)) {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeList& list = free_list();
+        Slot* slot = static_cast<Slot*>(ptr);
+        slot->next = list.head;
+        list.head = slot;
+        stats(name).releases.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct FreeList {
+        Slot* head = nullptr;
+    };
+
+    static FreeList& free_list() {
+        thread_local FreeList list;
+        return list;
+    }
+
+    static ObjectPoolStats& stats(const char* name) {
+        static ObjectPoolStats* pool_stats = ObjectPoolRegistry::add(name);
+        return *pool_stats;
+    }
+
+    static void refill(FreeList& list, const char* name) {
+        static_assert(alignof(Slot) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "over-aligned types are not supported");
+        Slot* slab =
+            static_cast<Slot*>(::operator new(sizeof(Slot) * SlabObjects));
+        for (std::size_t i = 0; i < SlabObjects; i++) {
+            slab[i].next = (i + 1 < SlabObjects) ? &slab[i + 1] : list.head;
+        }
+        list.head = slab;
+        stats(name).slabs.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+}  // namespace AstraSim
+
+// Routes new/delete of the enclosing class through ObjectPool<T>. CallData
+// and Callable have virtual destructors, so deleting through a base pointer
+// still returns the object to the pool of its dynamic type.
+#define ASTRA_SIM_POOLED_OBJECT(T)                                     \
+    static void* operator new(std::size_t size) {                      \
+        return ObjectPool<T>::allocate(size, #T);                      \
+    }                                                                  \
+    static void operator delete(void* ptr, std::size_t size) {         \
+        ObjectPool<T>::release(ptr, size, #T);                         \
+    }
+
+#endif /* __OBJECT_POOL_HH__ */
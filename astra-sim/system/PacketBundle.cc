@@ -21,6 +21,7 @@ PacketBundle::PacketBundle(Sys* sys,
     this->size = size;
     this->stream = stream;
     this->transmition = transmition;
+    this->notifier = nullptr;
     creation_time = Sys::boostedTick();
 }
 
@@ -36,6 +37,7 @@ PacketBundle::PacketBundle(Sys* sys,
     this->size = size;
     this->stream = stream;
     this->transmition = transmition;
+    this->notifier = nullptr;
     creation_time = Sys::boostedTick();
 }
 
@@ -67,6 +69,10 @@ void PacketBundle::call(EventType event, CallData* data) {
     for (auto& packet : locked_packets) {
         packet->ready_time = current;
     }
-    stream->call(EventType::General, data);
+    if (notifier != nullptr) {
+        notifier->call(EventType::General, data);
+    } else {
+        stream->call(EventType::General, data);
+    }
     delete this;
 }
@@ -11,12 +11,15 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/Common.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/MyPacket.hh"
+#include "astra-sim/system/ObjectPool.hh"
 
 namespace AstraSim {
 
 class Sys;
 class PacketBundle : public Callable {
   public:
+    ASTRA_SIM_POOLED_OBJECT(PacketBundle)
+
     PacketBundle(Sys* sys,
                  BaseStream* stream,
                  std::list<MyPacket*> locked_packets,
@@ -41,6 +44,8 @@ class PacketBundle : public Callable {
     uint64_t size;
     BaseStream* stream;
     MemBus::Transmition transmition;
+    // called instead of the stream when the bundle is done, if set
+    Callable* notifier;
     Tick delay;
     Tick creation_time;
 };
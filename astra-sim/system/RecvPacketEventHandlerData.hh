@@ -8,6 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
+#include "astra-sim/system/ObjectPool.hh"
 #include "astra-sim/system/astraccl/custom_collectives/CustomAlgorithm.hh"
 
 namespace AstraSim {
@@ -16,6 +17,8 @@ class WorkloadLayerHandlerData;
 
 class RecvPacketEventHandlerData : public BasicEventHandlerData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(RecvPacketEventHandlerData)
+
     RecvPacketEventHandlerData();
     RecvPacketEventHandlerData(BaseStream* owner,
                                int sys_id,
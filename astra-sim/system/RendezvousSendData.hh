@@ -8,6 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/BasicEventHandlerData.hh"
 #include "astra-sim/system/Common.hh"
+#include "astra-sim/system/ObjectPool.hh"
 #include "astra-sim/system/SimSendCaller.hh"
 #include "astra-sim/system/Sys.hh"
 
@@ -15,6 +16,8 @@ namespace AstraSim {
 
 class RendezvousSendData : public BasicEventHandlerData, public MetaData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(RendezvousSendData)
+
     RendezvousSendData(int sys_id,
                        Sys* sys,
                        void* buffer,
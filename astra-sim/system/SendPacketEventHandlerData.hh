@@ -9,12 +9,15 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/BasicEventHandlerData.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
+#include "astra-sim/system/ObjectPool.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
 
 namespace AstraSim {
 
 class SendPacketEventHandlerData : public BasicEventHandlerData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(SendPacketEventHandlerData)
+
     int tag;
     Callable* callable;
     WorkloadLayerHandlerData* wlhd;
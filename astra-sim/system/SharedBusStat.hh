@@ -7,11 +7,14 @@ LICENSE file in the root directory of this source tree.
 #define __SHARED_BUS_STAT_HH__
 
 #include "astra-sim/system/BasicEventHandlerData.hh"
+#include "astra-sim/system/ObjectPool.hh"
 
 namespace AstraSim {
 
 class SharedBusStat : public BasicEventHandlerData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(SharedBusStat)
+
     SharedBusStat(BusType busType,
                   double total_bus_transfer_queue_delay,
                   double total_bus_transfer_delay,
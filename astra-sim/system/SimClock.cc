@@ -0,0 +1,24 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/SimClock.hh"
+
+using namespace AstraSim;
+
+AstraNetworkAPI* SimClock::source = nullptr;
+Tick SimClock::current_tick = 0;
+
+void SimClock::set_source(AstraNetworkAPI* comm_NI) {
+    source = comm_NI;
+}
+
+void SimClock::refresh() {
+    if (source == nullptr) {
+        return;
+    }
+    SimProfiler::clock_backend_queries++;
+    timespec_t tmp = source->sim_get_time();
+    current_tick = tmp.time_val / CLOCK_PERIOD;
+}
@@ -0,0 +1,35 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __SIM_CLOCK_HH__
+#define __SIM_CLOCK_HH__
+
+#include "astra-sim/common/AstraNetworkAPI.hh"
+#include "astra-sim/system/SimProfiler.hh"
+
+namespace AstraSim {
+
+// Current simulation tick as seen by the system layer. The backend time is
+// queried once when the backend hands an event to the system layer
+// (Sys::handleEvent); everything else reads the cached value.
+class SimClock {
+  public:
+    static void set_source(AstraNetworkAPI* comm_NI);
+    static void refresh();
+
+    static Tick now() {
+        SimProfiler::clock_reads++;
+        return current_tick;
+    }
+
+    static AstraNetworkAPI* source;
+
+  private:
+    static Tick current_tick;
+};
+
+}  // namespace AstraSim
+
+#endif /* __SIM_CLOCK_HH__ */
@@ -0,0 +1,199 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/SimProfiler.hh"
+
+#include <fstream>
+#include <unistd.h>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/ObjectPool.hh"
+#include "astra-sim/system/StreamRegistry.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+bool SimProfiler::enabled = false;
+uint64_t SimProfiler::dispatched_events = 0;
+uint64_t SimProfiler::backend_wakeups = 0;
+uint64_t SimProfiler::clock_reads = 0;
+uint64_t SimProfiler::clock_backend_queries = 0;
+uint64_t SimProfiler::workload_ranks = 0;
+uint64_t SimProfiler::workload_graphs = 0;
+uint64_t SimProfiler::workload_graph_nodes = 0;
+uint64_t SimProfiler::workload_overlay_attrs = 0;
+uint64_t SimProfiler::workload_ets_decoded = 0;
+uint64_t SimProfiler::workload_ets_mapped = 0;
+double SimProfiler::workload_load_seconds = 0;
+uint64_t SimProfiler::workload_streamed_ranks = 0;
+uint64_t SimProfiler::workload_window_peak = 0;
+uint64_t SimProfiler::workload_wasted_examinations = 0;
+uint64_t SimProfiler::workload_avoided_examinations = 0;
+uint64_t SimProfiler::compute_model_lookups = 0;
+uint64_t SimProfiler::compute_model_memo_hits = 0;
+uint64_t SimProfiler::compute_model_fallbacks = 0;
+uint64_t SimProfiler::compute_scale_name_matches = 0;
+uint64_t SimProfiler::meshxy_pipelined_phases = 0;
+uint64_t SimProfiler::meshxy_sub_chunks = 0;
+uint64_t SimProfiler::meshxy_phase_ticks = 0;
+uint64_t SimProfiler::meshxy_overlap_ticks = 0;
+uint64_t SimProfiler::meshxy_plans_built = 0;
+uint64_t SimProfiler::meshxy_plan_hits = 0;
+uint64_t SimProfiler::alltoall_phases = 0;
+uint64_t SimProfiler::alltoall_pairs = 0;
+uint64_t SimProfiler::alltoall_pair_ticks = 0;
+uint64_t SimProfiler::alltoall_slowest_pair_ticks = 0;
+uint64_t SimProfiler::alltoall_worst_ticks = 0;
+int SimProfiler::alltoall_worst_src = -1;
+int SimProfiler::alltoall_worst_dst = -1;
+uint64_t SimProfiler::alltoall_worst_bytes = 0;
+int SimProfiler::startup_threads = 1;
+double SimProfiler::comm_group_seconds = 0;
+double SimProfiler::logical_topology_seconds = 0;
+chrono::steady_clock::time_point SimProfiler::startup_time;
+chrono::steady_clock::time_point SimProfiler::phase_start_time;
+vector<pair<string, double>> SimProfiler::startup_phases;
+mutex SimProfiler::startup_mutex;
+bool SimProfiler::started = false;
+int SimProfiler::finished_workloads = 0;
+chrono::steady_clock::time_point SimProfiler::start_time;
+
+void SimProfiler::startup_begin() {
+    startup_time = chrono::steady_clock::now();
+    phase_start_time = startup_time;
+}
+
+void SimProfiler::startup_phase(const string& name) {
+    const auto now = chrono::steady_clock::now();
+    startup_phases.emplace_back(
+        name, chrono::duration<double>(now - phase_start_time).count());
+    phase_start_time = now;
+}
+
+void SimProfiler::add_startup_seconds(double& total,
+                                      chrono::steady_clock::time_point since) {
+    const double elapsed_sec =
+        chrono::duration<double>(chrono::steady_clock::now() - since).count();
+    lock_guard<mutex> lock(startup_mutex);
+    total += elapsed_sec;
+}
+
+void SimProfiler::report_startup(int num_npus) {
+    if (!enabled) {
+        return;
+    }
+    double elapsed_sec =
+        chrono::duration<double>(chrono::steady_clock::now() - startup_time)
+            .count();
+    auto logger = LoggerFactory::get_logger("system::profile");
+    logger->info("startup: {} NPUs in {:.3f} sec wall time, {:.1f} MiB resident",
+                 num_npus, elapsed_sec,
+                 resident_memory_bytes() / (1024.0 * 1024.0));
+    string phases;
+    for (const auto& phase : startup_phases) {
+        phases += fmt::format("{}{} {:.3f} sec", phases.empty() ? "" : ", ",
+                              phase.first, phase.second);
+    }
+    logger->info("startup phases: {} ({} construction threads)", phases,
+                 startup_threads);
+    logger->info("startup work summed over ranks: {:.3f} sec loading "
+                 "workload graphs, {:.3f} sec parsing communicator groups, "
+                 "{:.3f} sec setting up logical topologies",
+                 workload_load_seconds, comm_group_seconds,
+                 logical_topology_seconds);
+    logger->info("workload graphs: {} ranks share {} distinct graphs of {} "
+                 "nodes, {} overlay attributes",
+                 workload_ranks, workload_graphs, workload_graph_nodes,
+                 workload_overlay_attrs);
+    logger->info("workload ETs: {} decoded from protobuf, {} mapped from the "
+                 "compiled cache",
+                 workload_ets_decoded, workload_ets_mapped);
+}
+
+uint64_t SimProfiler::resident_memory_bytes() {
+    // second field of /proc/self/statm is the resident set in pages
+    ifstream statm("/proc/self/statm");
+    uint64_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+void SimProfiler::start() {
+    if (!started) {
+        started = true;
+        start_time = chrono::steady_clock::now();
+    }
+}
+
+void SimProfiler::notify_workload_finished(int num_workloads) {
+    if (++finished_workloads == num_workloads) {
+        report();
+    }
+}
+
+void SimProfiler::report() {
+    if (!enabled) {
+        return;
+    }
+    double elapsed_sec =
+        chrono::duration<double>(chrono::steady_clock::now() - start_time)
+            .count();
+    auto logger = LoggerFactory::get_logger("system::profile");
+    logger->info("simulation loop: {:.3f} sec wall time", elapsed_sec);
+    logger->info("events: {} dispatched, {} backend wake-ups, {:.0f} events/sec",
+                 dispatched_events, backend_wakeups,
+                 elapsed_sec > 0 ? dispatched_events / elapsed_sec : 0.0);
+    logger->info("ready queues: {} wasted re-examinations of nodes behind a "
+                 "busy resource, {} avoided",
+                 workload_wasted_examinations, workload_avoided_examinations);
+    if (workload_streamed_ranks > 0) {
+        logger->info("workload streaming: {} ranks read their ET through a "
+                     "window of at most {} nodes",
+                     workload_streamed_ranks, workload_window_peak);
+    }
+    if (compute_model_lookups > 0) {
+        logger->info("compute model: {} kernel lookups, {} memoized, {} not "
+                     "in the kernel table",
+                     compute_model_lookups, compute_model_memo_hits,
+                     compute_model_fallbacks);
+    }
+    if (compute_scale_name_matches > 0) {
+        logger->info("compute scale: {} node names matched against the rules",
+                     compute_scale_name_matches);
+    }
+    if (meshxy_plans_built > 0) {
+        logger->info("MeshXY neighbor plans: {} built, reused by {} instances",
+                     meshxy_plans_built, meshxy_plan_hits);
+    }
+    if (alltoall_phases > 0) {
+        logger->info("MeshXY all-to-all: {} phases, {:.1f} ticks per pair and "
+                     "{:.1f} for the slowest pair of a phase on average, "
+                     "slowest pair {}->{} ({} bytes) in {} ticks",
+                     alltoall_phases,
+                     static_cast<double>(alltoall_pair_ticks) / alltoall_pairs,
+                     static_cast<double>(alltoall_slowest_pair_ticks) /
+                         alltoall_phases,
+                     alltoall_worst_src, alltoall_worst_dst,
+                     alltoall_worst_bytes, alltoall_worst_ticks);
+    }
+    if (meshxy_pipelined_phases > 0) {
+        logger->info("MeshXY pipelining: {} phases in {:.1f} sub-chunks on "
+                     "average, X and Y busy together {:.1f}% of the time",
+                     meshxy_pipelined_phases,
+                     static_cast<double>(meshxy_sub_chunks) /
+                         meshxy_pipelined_phases,
+                     meshxy_phase_ticks > 0 ? 100.0 * meshxy_overlap_ticks /
+                                                  meshxy_phase_ticks
+                                            : 0.0);
+    }
+    logger->info("clock: {} tick reads, {} backend time queries", clock_reads,
+                 clock_backend_queries);
+    logger->info("streams: {} live stream slots, {} allocated",
+                 StreamRegistry::live_slots(),
+                 StreamRegistry::allocated_slots());
+    ObjectPoolRegistry::report();
+}
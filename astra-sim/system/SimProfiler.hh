@@ -0,0 +1,110 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __SIM_PROFILER_HH__
+#define __SIM_PROFILER_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace AstraSim {
+
+// Process-wide counters of the simulator's own work (not of the simulated
+// system). They are always collected and only printed when
+// "report-profile" is enabled in the sys input file.
+class SimProfiler {
+  public:
+    // frontend setup, from the first call until all Sys are constructed
+    static void startup_begin();
+    // end the current startup phase, which is reported as 'name'
+    static void startup_phase(const std::string& name);
+    // add the time since 'since' to 'total'; callable from any thread
+    static void add_startup_seconds(double& total,
+                                    std::chrono::steady_clock::time_point since);
+    static void report_startup(int num_npus);
+    static uint64_t resident_memory_bytes();
+
+    static void start();
+    static void notify_workload_finished(int num_workloads);
+    static void report();
+
+    static bool enabled;
+
+    // system-layer events executed by Sys::call_events
+    static uint64_t dispatched_events;
+    // backend callbacks that drained a Sys event store
+    static uint64_t backend_wakeups;
+    // Sys::boostedTick reads and the backend time queries behind them
+    static uint64_t clock_reads;
+    static uint64_t clock_backend_queries;
+    // workload graphs loaded by the ranks, and how many of them are distinct
+    static uint64_t workload_ranks;
+    static uint64_t workload_graphs;
+    static uint64_t workload_graph_nodes;
+    static uint64_t workload_overlay_attrs;
+    // Chakra ETs decoded from protobuf or mapped from the compiled cache,
+    // and the time spent loading workload graphs, summed over ranks
+    static uint64_t workload_ets_decoded;
+    static uint64_t workload_ets_mapped;
+    static double workload_load_seconds;
+    // ranks streaming their ET through a bounded window, and the largest
+    // window any of them held
+    static uint64_t workload_streamed_ranks;
+    static uint64_t workload_window_peak;
+    // examinations of a waiting node whose resource was still busy, and the
+    // ones the per-resource ready queues skipped compared with re-examining
+    // every waiting node on every workload callback
+    static uint64_t workload_wasted_examinations;
+    static uint64_t workload_avoided_examinations;
+    // compute node durations looked up in the kernel table, the ones served
+    // from the per-rank memo, and the ones it does not model
+    static uint64_t compute_model_lookups;
+    static uint64_t compute_model_memo_hits;
+    static uint64_t compute_model_fallbacks;
+    // node names matched against the compute scale rules, once per rank
+    static uint64_t compute_scale_name_matches;
+    // MeshXY collective phases pipelined in sub-chunks, their sub-chunks,
+    // and the ticks they ran, in total and with both X and Y busy
+    static uint64_t meshxy_pipelined_phases;
+    static uint64_t meshxy_sub_chunks;
+    static uint64_t meshxy_phase_ticks;
+    static uint64_t meshxy_overlap_ticks;
+    // MeshXY neighbor plans built, and instances that reused one
+    static uint64_t meshxy_plans_built;
+    static uint64_t meshxy_plan_hits;
+    // MeshXY all-to-alls that received traffic, their received pairs, the
+    // ticks until each pair and the slowest pair of each arrived, and the
+    // slowest pair of all
+    static uint64_t alltoall_phases;
+    static uint64_t alltoall_pairs;
+    static uint64_t alltoall_pair_ticks;
+    static uint64_t alltoall_slowest_pair_ticks;
+    static uint64_t alltoall_worst_ticks;
+    static int alltoall_worst_src;
+    static int alltoall_worst_dst;
+    static uint64_t alltoall_worst_bytes;
+    // threads constructing the Sys of the ranks, and the time spent parsing
+    // communicator groups and setting up logical topologies, summed over ranks
+    static int startup_threads;
+    static double comm_group_seconds;
+    static double logical_topology_seconds;
+
+  private:
+    static std::chrono::steady_clock::time_point startup_time;
+    static std::chrono::steady_clock::time_point phase_start_time;
+    static std::vector<std::pair<std::string, double>> startup_phases;
+    static std::mutex startup_mutex;
+    static bool started;
+    static int finished_workloads;
+    static std::chrono::steady_clock::time_point start_time;
+};
+
+}  // namespace AstraSim
+
+#endif /* __SIM_PROFILER_HH__ */
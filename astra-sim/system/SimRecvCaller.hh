@@ -9,12 +9,15 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/CallData.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
+#include "astra-sim/system/ObjectPool.hh"
 #include "astra-sim/system/Sys.hh"
 
 namespace AstraSim {
 
 class SimRecvCaller : public Callable {
   public:
+    ASTRA_SIM_POOLED_OBJECT(SimRecvCaller)
+
     void* buffer;
     int count;
     int type;
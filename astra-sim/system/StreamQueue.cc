@@ -0,0 +1,147 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/StreamQueue.hh"
+
+#include <algorithm>
+
+#include "astra-sim/system/BaseStream.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+StreamQueue::StreamQueue() {
+    first_pending = streams.end();
+    order = StreamOrder::None;
+}
+
+int64_t StreamQueue::key_of(BaseStream* stream, StreamOrder order) {
+    switch (order) {
+    case StreamOrder::DescendingPriority:
+        return -static_cast<int64_t>(stream->priority);
+    case StreamOrder::AscendingPhases:
+        return static_cast<int64_t>(stream->phases_to_go.size());
+    case StreamOrder::AscendingSize:
+        return static_cast<int64_t>(
+            max(stream->my_current_phase.initial_data_size,
+                stream->my_current_phase.final_data_size));
+    default:
+        return 0;
+    }
+}
+
+void StreamQueue::insert_ordered(BaseStream* stream,
+                                 StreamOrder order,
+                                 bool upper) {
+    int64_t key = key_of(stream, order);
+    if (this->order == StreamOrder::None) {
+        this->order = order;
+    }
+    if (this->order == order) {
+        auto next = upper ? index.upper_bound(key) : index.lower_bound(key);
+        link(next == index.end() ? streams.end() : next->second, stream);
+        stream->queue_entry.index_position =
+            index.insert(next, make_pair(key, stream->queue_entry.position));
+        stream->queue_entry.indexed = true;
+        return;
+    }
+    iterator position = first_pending;
+    while (position != streams.end()) {
+        int64_t other = key_of(*position, order);
+        if (other < key || (upper && other == key)) {
+            ++position;
+        } else {
+            break;
+        }
+    }
+    insert_at(position, stream);
+}
+
+void StreamQueue::append(BaseStream* stream, StreamOrder order) {
+    if (this->order == StreamOrder::None) {
+        this->order = order;
+    }
+    if (this->order == order) {
+        int64_t key = key_of(stream, order);
+        if (index.empty() || index.rbegin()->first <= key) {
+            link(streams.end(), stream);
+            stream->queue_entry.index_position = index.insert(
+                index.end(), make_pair(key, stream->queue_entry.position));
+            stream->queue_entry.indexed = true;
+            return;
+        }
+    }
+    insert_at(streams.end(), stream);
+}
+
+void StreamQueue::insert_at(iterator position, BaseStream* stream) {
+    link(position, stream);
+    if (order != StreamOrder::Unordered) {
+        order = StreamOrder::Unordered;
+        drop_index();
+    }
+}
+
+BaseStream* StreamQueue::start_next_pending() {
+    BaseStream* stream = *first_pending;
+    unindex(stream);
+    stream->queue_entry.pending = false;
+    ++first_pending;
+    if (!has_pending()) {
+        order = StreamOrder::None;
+    }
+    return stream;
+}
+
+bool StreamQueue::erase(BaseStream* stream) {
+    StreamQueueEntry& entry = stream->queue_entry;
+    if (entry.queue != this) {
+        return false;
+    }
+    if (entry.pending) {
+        unindex(stream);
+        if (entry.position == first_pending) {
+            ++first_pending;
+        }
+    }
+    streams.erase(entry.position);
+    entry.queue = nullptr;
+    entry.pending = false;
+    if (!has_pending()) {
+        order = StreamOrder::None;
+    }
+    return true;
+}
+
+void StreamQueue::pop_front() {
+    erase(streams.front());
+}
+
+void StreamQueue::link(iterator position, BaseStream* stream) {
+    iterator inserted = streams.insert(position, stream);
+    if (position == first_pending) {
+        first_pending = inserted;
+    }
+    StreamQueueEntry& entry = stream->queue_entry;
+    entry.queue = this;
+    entry.position = inserted;
+    entry.pending = true;
+    entry.indexed = false;
+}
+
+void StreamQueue::unindex(BaseStream* stream) {
+    StreamQueueEntry& entry = stream->queue_entry;
+    if (entry.indexed) {
+        index.erase(entry.index_position);
+        entry.indexed = false;
+    }
+}
+
+void StreamQueue::drop_index() {
+    for (auto& indexed : index) {
+        (*indexed.second)->queue_entry.indexed = false;
+    }
+    index.clear();
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __STREAM_QUEUE_HH__
+#define __STREAM_QUEUE_HH__
+
+#include <cstdint>
+#include <list>
+#include <map>
+
+namespace AstraSim {
+
+class BaseStream;
+class StreamQueue;
+
+// Sort order of the not-yet-initialized part of a StreamQueue. It follows
+// the rule of the insertions made since that part was last empty.
+enum class StreamOrder {
+    None = 0,            // nothing pending
+    DescendingPriority,  // FIFO: after every stream of higher/equal priority
+    AscendingPhases,     // LessRemainingPhaseFirst
+    AscendingSize,       // SmallestFirst
+    Unordered            // mixed rules or positional inserts
+};
+
+// Position of a stream in the StreamQueue that holds it.
+struct StreamQueueEntry {
+    StreamQueue* queue = nullptr;
+    std::list<BaseStream*>::iterator position;
+    std::multimap<int64_t, std::list<BaseStream*>::iterator>::iterator
+        index_position;
+    bool pending = false;
+    bool indexed = false;
+};
+
+// Queue of streams made of an initialized prefix followed by the streams
+// waiting for initialization. 'first_pending' is an O(1) cursor to the
+// boundary. While the pending part is sorted by a single key it is also
+// indexed by that key, so that ordered insertions take O(log n); otherwise
+// they walk the pending part as the original list-based queue did.
+class StreamQueue {
+  public:
+    typedef std::list<BaseStream*>::iterator iterator;
+
+    StreamQueue();
+    StreamQueue(const StreamQueue&) = delete;
+    StreamQueue& operator=(const StreamQueue&) = delete;
+
+    // inserts 'stream' right before the first pending stream whose key is
+    // greater than (upper = true) or not less than (upper = false) its own
+    void insert_ordered(BaseStream* stream, StreamOrder order, bool upper);
+    // inserts 'stream' after every other stream, keeping the index when
+    // 'stream' does not break the current order
+    void append(BaseStream* stream, StreamOrder order);
+    // inserts 'stream' at a position chosen by the caller, which has to be
+    // within the pending part
+    void insert_at(iterator position, BaseStream* stream);
+    // moves the cursor over the first pending stream and returns it
+    BaseStream* start_next_pending();
+    bool erase(BaseStream* stream);
+    void pop_front();
+
+    bool has_pending() const {
+        return first_pending != streams.end();
+    }
+    BaseStream* front() const {
+        return streams.front();
+    }
+    uint64_t size() const {
+        return streams.size();
+    }
+    bool empty() const {
+        return streams.empty();
+    }
+    iterator begin() {
+        return streams.begin();
+    }
+    iterator end() {
+        return streams.end();
+    }
+    iterator pending_begin() {
+        return first_pending;
+    }
+
+  private:
+    static int64_t key_of(BaseStream* stream, StreamOrder order);
+    void link(iterator position, BaseStream* stream);
+    void unindex(BaseStream* stream);
+    void drop_index();
+
+    std::list<BaseStream*> streams;
+    iterator first_pending;
+    StreamOrder order;
+    std::multimap<int64_t, iterator> index;
+};
+
+}  // namespace AstraSim
+
+#endif /* __STREAM_QUEUE_HH__ */
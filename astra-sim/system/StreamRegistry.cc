@@ -0,0 +1,81 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/StreamRegistry.hh"
+
+#include <cassert>
+#include <mutex>
+
+using namespace std;
+using namespace AstraSim;
+
+vector<StreamRegistry::Namespace> StreamRegistry::namespaces;
+vector<StreamSlot> StreamRegistry::slots;
+vector<int> StreamRegistry::free_slots;
+
+StreamRegistry::Namespace& StreamRegistry::get_namespace(
+    int stream_namespace) {
+    assert(stream_namespace >= 0);
+    if (static_cast<uint64_t>(stream_namespace) >= namespaces.size()) {
+        namespaces.resize(stream_namespace + 1);
+    }
+    return namespaces[stream_namespace];
+}
+
+void StreamRegistry::set_participants(int stream_namespace,
+                                      int participants) {
+    static mutex participants_mutex;
+    lock_guard<mutex> lock(participants_mutex);
+    get_namespace(stream_namespace).participants = participants;
+}
+
+int StreamRegistry::acquire(int stream_id, int default_participants) {
+    Namespace& ns = get_namespace(stream_id / STREAM_ID_NAMESPACE_SIZE);
+    int64_t seq = stream_id % STREAM_ID_NAMESPACE_SIZE;
+    // a recycled id would need every participant to have finished it
+    assert(seq >= ns.window_start);
+    uint64_t offset = seq - ns.window_start;
+    if (offset >= ns.window.size()) {
+        ns.window.resize(offset + 1, NOT_CREATED);
+    }
+    int& slot_index = ns.window[offset];
+    assert(slot_index != RECYCLED);
+    if (slot_index == NOT_CREATED) {
+        if (!free_slots.empty()) {
+            slot_index = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot_index = slots.size();
+            slots.emplace_back();
+        }
+        StreamSlot& new_slot = slots[slot_index];
+        new_slot.stream_id = stream_id;
+        new_slot.participants =
+            ns.participants > 0 ? ns.participants : default_participants;
+        new_slot.created = 0;
+        new_slot.ready = 0;
+        new_slot.finished = 0;
+    }
+    slots[slot_index].created++;
+    return slot_index;
+}
+
+void StreamRegistry::release(int slot_index) {
+    StreamSlot& finished_slot = slots[slot_index];
+    if (++finished_slot.finished < finished_slot.created ||
+        finished_slot.created < finished_slot.participants) {
+        return;
+    }
+    Namespace& ns =
+        get_namespace(finished_slot.stream_id / STREAM_ID_NAMESPACE_SIZE);
+    int64_t seq = finished_slot.stream_id % STREAM_ID_NAMESPACE_SIZE;
+    ns.window[seq - ns.window_start] = RECYCLED;
+    free_slots.push_back(slot_index);
+    // ids are finished roughly in order; slide past the recycled ones
+    while (!ns.window.empty() && ns.window.front() == RECYCLED) {
+        ns.window.pop_front();
+        ns.window_start++;
+    }
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __STREAM_REGISTRY_HH__
+#define __STREAM_REGISTRY_HH__
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace AstraSim {
+
+// Stream ids double as message tags, so every rank numbers its streams the
+// same way: communicator group g hands out ids from
+// [g * STREAM_ID_NAMESPACE_SIZE, (g + 1) * STREAM_ID_NAMESPACE_SIZE) and
+// streams outside any group use namespace 0.
+constexpr int STREAM_ID_NAMESPACE_SIZE = 1000000;
+
+// Cross-rank bookkeeping of one stream id.
+struct StreamSlot {
+    int stream_id;
+    int participants;  // ranks expected to create a stream with this id
+    int created;       // formerly BaseStream::synchronizer[stream_id]
+    int ready;         // ranks waiting on this stream at the schedule barrier
+    int finished;
+};
+
+// Maps stream ids to dense, recycled slots. Within a namespace ids are
+// allocated in sequence, so the live ids form a sliding window that is
+// indexed directly. A slot is recycled once every participant has created
+// and finished its stream, which keeps memory flat over long runs.
+class StreamRegistry {
+  public:
+    // number of ranks that share the streams of 'stream_namespace';
+    // namespaces without a registered group span all ranks. Communicator
+    // groups register while ranks are constructed, possibly concurrently.
+    static void set_participants(int stream_namespace, int participants);
+    static int acquire(int stream_id, int default_participants);
+    static void release(int slot_index);
+
+    static StreamSlot& slot(int slot_index) {
+        return slots[slot_index];
+    }
+
+    static uint64_t live_slots() {
+        return slots.size() - free_slots.size();
+    }
+    static uint64_t allocated_slots() {
+        return slots.size();
+    }
+
+  private:
+    struct Namespace {
+        int participants = -1;
+        int64_t window_start = 0;  // sequence number of window.front()
+        std::deque<int> window;    // slot index, or one of the below
+    };
+
+    static constexpr int NOT_CREATED = -1;
+    static constexpr int RECYCLED = -2;
+
+    static Namespace& get_namespace(int stream_namespace);
+
+    static std::vector<Namespace> namespaces;
+    static std::vector<StreamSlot> slots;
+    static std::vector<int> free_slots;
+};
+
+}  // namespace AstraSim
+
+#endif /* __STREAM_REGISTRY_HH__ */
@@ -5,12 +5,15 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/Sys.hh"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <numeric>
 
 #include "astra-sim/common/Logging.hh"
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/CollectivePlan.hh"
+#include "astra-sim/system/ComputeModel.hh"
 #include "astra-sim/system/DataSet.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/MemEventHandlerData.hh"
@@ -18,9 +21,13 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/RendezvousRecvData.hh"
 #include "astra-sim/system/RendezvousSendData.hh"
 #include "astra-sim/system/SendPacketEventHandlerData.hh"
+#include "astra-sim/system/SimClock.hh"
+#include "astra-sim/system/SimProfiler.hh"
 #include "astra-sim/system/SimRecvCaller.hh"
 #include "astra-sim/system/SimSendCaller.hh"
 #include "astra-sim/system/StreamBaseline.hh"
+#include "astra-sim/system/StreamRegistry.hh"
+#include "astra-sim/system/SystemConfig.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
 #include "astra-sim/system/astraccl/custom_collectives/CustomAlgorithm.hh"
 #include "astra-sim/system/astraccl/native_collectives/collective_algorithm/AllToAll.hh"
@@ -31,15 +38,19 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/scheduling/OfflineGreedy.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/BasicLogicalTopology.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/GeneralComplexTopology.hh"
-#include <json/json.hpp>
 
 using namespace std;
 using namespace Chakra;
-using json = nlohmann::json;
 
 namespace AstraSim {
 uint8_t* Sys::dummy_data = new uint8_t[2];
 vector<Sys*> Sys::all_sys;
+int Sys::num_sys = 0;
+mutex Sys::registration_mutex;
+bool Sys::tick_wheel_enabled = false;
+bool Sys::tick_wheel_dispatching = false;
+CalendarQueue<int>* Sys::tick_wheel = nullptr;
+bool Sys::barrier_firing = false;
 
 // SchedulerUnit --------------------------------------------------------------
 Sys::SchedulerUnit::SchedulerUnit(Sys* sys,
@@ -60,8 +71,6 @@ Sys::SchedulerUnit::SchedulerUnit(Sys* sys,
     for (auto q : queues) {
         for (int i = 0; i < q; i++) {
             this->running_streams[base] = 0;
-            list<BaseStream*>::iterator it;
-            this->stream_pointer[base] = it;
             this->queue_id_to_dimension[base] = dimension;
             base++;
         }
@@ -76,13 +85,10 @@ void Sys::SchedulerUnit::notify_stream_added(int vnet) {
         ++total_active_chunks_per_dimension[queue_id_to_dimension[vnet]] == 1) {
         usage[queue_id_to_dimension[vnet]].increase_usage();
     }
-    stream_pointer[vnet] = sys->active_Streams[vnet].begin();
-    advance(stream_pointer[vnet], running_streams[vnet]);
-    while (stream_pointer[vnet] != sys->active_Streams[vnet].end() &&
-           running_streams[vnet] < queue_threshold) {
-        (*stream_pointer[vnet])->init();
+    StreamQueue& queue = sys->active_Streams[vnet];
+    while (queue.has_pending() && running_streams[vnet] < queue_threshold) {
+        queue.start_next_pending()->init();
         running_streams[vnet]++;
-        advance(stream_pointer[vnet], 1);
     }
 }
 
@@ -93,7 +99,11 @@ void Sys::SchedulerUnit::notify_stream_added_into_ready_list() {
         if (max > max_running_streams - this->sys->total_running_streams) {
             max = max_running_streams - this->sys->total_running_streams;
         }
-        sys->schedule(max);
+        if (sys->synchronized_scheduling) {
+            sys->ask_for_schedule(max);
+        } else {
+            sys->schedule(max);
+        }
     }
     return;
 }
@@ -115,15 +125,16 @@ void Sys::SchedulerUnit::notify_stream_removed(int vnet, Tick running_time) {
         if (max > max_running_streams - this->sys->total_running_streams) {
             max = max_running_streams - this->sys->total_running_streams;
         }
-        sys->schedule(max);
+        if (sys->synchronized_scheduling) {
+            sys->ask_for_schedule(max);
+        } else {
+            sys->schedule(max);
+        }
     }
-    stream_pointer[vnet] = sys->active_Streams[vnet].begin();
-    advance(stream_pointer[vnet], running_streams[vnet]);
-    while (stream_pointer[vnet] != sys->active_Streams[vnet].end() &&
-           running_streams[vnet] < queue_threshold) {
-        (*stream_pointer[vnet])->init();
+    StreamQueue& queue = sys->active_Streams[vnet];
+    while (queue.has_pending() && running_streams[vnet] < queue_threshold) {
+        queue.start_next_pending()->init();
         running_streams[vnet]++;
-        advance(stream_pointer[vnet], 1);
     }
 }
 
@@ -147,23 +158,64 @@ Sys::Sys(int id,
          vector<int> queues_per_dim,
          double injection_scale,
          double comm_scale,
+         double compute_scale,
+         bool rendezvous_enabled)
+    : Sys(id,
+          workload_configuration,
+          comm_group_configuration,
+          SystemConfig::load(system_configuration),
+          remote_mem,
+          comm_NI,
+          physical_dims,
+          queues_per_dim,
+          injection_scale,
+          comm_scale,
+          compute_scale,
+          rendezvous_enabled) {}
+
+Sys::Sys(int id,
+         string workload_configuration,
+         string comm_group_configuration,
+         shared_ptr<const SystemConfig> system_config,
+         AstraRemoteMemoryAPI* remote_mem,
+         AstraNetworkAPI* comm_NI,
+         vector<int> physical_dims,
+         vector<int> queues_per_dim,
+         double injection_scale,
+         double comm_scale,
+         double compute_scale,
          bool rendezvous_enabled) {
-    if ((id + 1) > this->all_sys.size()) {
-        this->all_sys.resize(id + 1);
+    {
+        // all_sys is indexed by rank, so the order in which concurrently
+        // constructed ranks register does not matter
+        lock_guard<mutex> lock(registration_mutex);
+        if ((id + 1) > this->all_sys.size()) {
+            this->all_sys.resize(id + 1);
+        }
+        this->all_sys[id] = this;
+        num_sys++;
+        remote_mem->set_sys(id, this);
+        // the clock follows the lowest rank, as with serial construction
+        auto lowest = find_if(all_sys.begin(), all_sys.end(),
+                              [](Sys* sys) { return sys != nullptr; });
+        if (*lowest == this) {
+            SimClock::set_source(comm_NI);
+        }
     }
-    this->all_sys[id] = this;
 
     this->id = id;
     this->initialized = false;
+    this->barrier_slot = -1;
 
     this->workload = nullptr;
 
     this->roofline_enabled = false;
     this->peak_perf = 0;
     this->roofline = nullptr;
+    this->compute_model = nullptr;
+    this->compute_scale = compute_scale;
 
     this->remote_mem = remote_mem;
-    this->remote_mem->set_sys(id, this);
     this->local_mem_bw = 0;
 
     this->memBus = nullptr;
@@ -191,6 +243,10 @@ Sys::Sys(int id,
     this->pending_events = 0;
     this->preferred_dataset_splits = 0;
 
+    this->event_store_type = EventStoreType::Map;
+    this->event_store_buckets = 256;
+    this->event_store = nullptr;
+
     this->last_scheduled_collective = 0;
 
     this->first_phase_streams = 0;
@@ -199,10 +255,9 @@ Sys::Sys(int id,
     this->communication_delay = 10;
     this->local_reduction_delay = 1;
 
-    if (initialize_sys(system_configuration) == false) {
-        sys_panic("Unable to initialize the system layer because the file can "
-                  "not be openned");
-    }
+    this->system_config = system_config;
+    initialize_sys(*system_config);
+    event_store = EventStore::create(event_store_type, event_store_buckets);
 
     // scheduler
     this->physical_dims = physical_dims;
@@ -216,8 +271,7 @@ Sys::Sys(int id,
             this->total_nodes *= physical_dims[current_dim];
         }
         for (int j = 0; j < queues_per_dim[current_dim]; j++) {
-            list<BaseStream*> temp;
-            active_Streams[element] = temp;
+            active_Streams[element];
             list<int> pri;
             stream_priorities[element] = pri;
             element++;
@@ -237,6 +291,7 @@ Sys::Sys(int id,
     // collective communication
     this->num_streams = 0;
 
+    const auto topology_start = chrono::steady_clock::now();
     logical_topologies["AllReduce"] = new GeneralComplexTopology(
         id, physical_dims, all_reduce_implementation_per_dimension);
     logical_topologies["ReduceScatter"] = new GeneralComplexTopology(
@@ -245,6 +300,8 @@ Sys::Sys(int id,
         id, physical_dims, all_gather_implementation_per_dimension);
     logical_topologies["AllToAll"] = new GeneralComplexTopology(
         id, physical_dims, all_to_all_implementation_per_dimension);
+    SimProfiler::add_startup_seconds(SimProfiler::logical_topology_seconds,
+                                     topology_start);
 
     memBus = new MemBus("NPU", "MA", this, inp_L, inp_o, inp_g, inp_G,
                         model_shared_bus, communication_delay, true);
@@ -268,8 +325,21 @@ Sys::~Sys() {
     if (roofline_enabled) {
         delete this->roofline;
     }
+    delete this->compute_model;
 
+    if (barrier_slot != -1) {
+        StreamRegistry::slot(barrier_slot).ready--;
+    }
     all_sys[id] = nullptr;
+    if (SimClock::source == comm_NI) {
+        SimClock::source = nullptr;
+        for (auto sys : all_sys) {
+            if (sys != nullptr) {
+                SimClock::source = sys->comm_NI;
+                break;
+            }
+        }
+    }
 
     for (auto lt : logical_topologies) {
         delete lt.second;
@@ -277,16 +347,9 @@ Sys::~Sys() {
 
     logical_topologies.clear();
 
-    for (auto ci : all_reduce_implementation_per_dimension) {
-        delete ci;
-    }
-    for (auto ci : reduce_scatter_implementation_per_dimension) {
-        delete ci;
-    }
-    for (auto ci : all_gather_implementation_per_dimension) {
-        delete ci;
-    }
-    for (auto ci : all_to_all_implementation_per_dimension) {
+    // the implementations parsed from the sys input file belong to
+    // system_config
+    for (auto ci : owned_collective_impls) {
         delete ci;
     }
 
@@ -310,6 +373,10 @@ Sys::~Sys() {
         delete offline_greedy;
     }
 
+    if (event_store != nullptr) {
+        delete event_store;
+    }
+
     bool shouldExit = true;
     for (auto& a : all_sys) {
         if (a != nullptr) {
@@ -323,216 +390,74 @@ Sys::~Sys() {
     }
 }
 
-bool Sys::initialize_sys(string name) {
-    ifstream inFile;
-    inFile.open(name);
-    if (!inFile) {
-        if (id == 0) {
-            LoggerFactory::get_logger("system")->critical(
-                "Unable to open file: {}", name);
-        }
-        exit(1);
-    }
-
-    json j;
-    inFile >> j;
-    if (j.contains("scheduling-policy")) {
-        string inp_scheduling_policy = j["scheduling-policy"];
-        if (inp_scheduling_policy == "LIFO") {
-            this->scheduling_policy = SchedulingPolicy::LIFO;
-        } else if (inp_scheduling_policy == "FIFO") {
-            this->scheduling_policy = SchedulingPolicy::FIFO;
-        } else if (inp_scheduling_policy == "EXPLICIT") {
-            this->scheduling_policy = SchedulingPolicy::EXPLICIT;
-        } else {
-            sys_panic("unknown value for scheduling policy in sys input file");
-        }
-    }
-    if (j.contains("all-reduce-implementation")) {
-        vector<string> collective_impl_str_vec = j["all-reduce-implementation"];
-        for (auto collective_impl_str : collective_impl_str_vec) {
-            CollectiveImpl* ci =
-                generate_collective_impl_from_input(collective_impl_str);
-            all_reduce_implementation_per_dimension.push_back(ci);
-        }
-    }
-    if (j.contains("reduce-scatter-implementation")) {
-        vector<string> collective_impl_str_vec =
-            j["reduce-scatter-implementation"];
-        for (auto collective_impl_str : collective_impl_str_vec) {
-            CollectiveImpl* ci =
-                generate_collective_impl_from_input(collective_impl_str);
-            reduce_scatter_implementation_per_dimension.push_back(ci);
-        }
-    }
-    if (j.contains("all-gather-implementation")) {
-        vector<string> collective_impl_str_vec = j["all-gather-implementation"];
-        for (auto collective_impl_str : collective_impl_str_vec) {
-            CollectiveImpl* ci =
-                generate_collective_impl_from_input(collective_impl_str);
-            all_gather_implementation_per_dimension.push_back(ci);
-        }
-    }
-    if (j.contains("all-to-all-implementation")) {
-        vector<string> collective_impl_str_vec = j["all-to-all-implementation"];
-        for (auto collective_impl_str : collective_impl_str_vec) {
-            CollectiveImpl* ci =
-                generate_collective_impl_from_input(collective_impl_str);
-            all_to_all_implementation_per_dimension.push_back(ci);
-        }
-    }
-    if (j.contains("all-to-all-implementation-custom")) {
-        vector<string> chakra_filepath_str_vec =
-            j["all-to-all-implementation-custom"];
-        all_to_all_implementation_per_dimension.clear();
-        if (chakra_filepath_str_vec.size() != 1) {
-            throw logic_error(
-                "There should be 1 Chakra ET only. In multi-dim collectives, "
-                "that 1 ET file covers all dimensions");
-        }
-        CollectiveImpl* ci =
-            generate_custom_collective_impl(chakra_filepath_str_vec[0]);
-        all_to_all_implementation_per_dimension.push_back(ci);
-    }
-    if (j.contains("all-gather-implementation-custom")) {
-        vector<string> chakra_filepath_str_vec =
-            j["all-gather-implementation-custom"];
-        all_gather_implementation_per_dimension.clear();
-        if (chakra_filepath_str_vec.size() != 1) {
-            throw logic_error(
-                "There should be 1 Chakra ET only. In multi-dim collectives, "
-                "that 1 ET file covers all dimensions");
-        }
-        CollectiveImpl* ci =
-            generate_custom_collective_impl(chakra_filepath_str_vec[0]);
-        all_gather_implementation_per_dimension.push_back(ci);
-    }
-    if (j.contains("all-reduce-implementation-custom")) {
-        vector<string> chakra_filepath_str_vec =
-            j["all-reduce-implementation-custom"];
-        all_reduce_implementation_per_dimension.clear();
-        if (chakra_filepath_str_vec.size() != 1) {
-            throw logic_error(
-                "There should be 1 Chakra ET only. In multi-dim collectives, "
-                "that 1 ET file covers all dimensions");
-        }
-        CollectiveImpl* ci =
-            generate_custom_collective_impl(chakra_filepath_str_vec[0]);
-        all_reduce_implementation_per_dimension.push_back(ci);
-    }
-    if (j.contains("collective-optimization")) {
-        string inp_collective_optimization = j["collective-optimization"];
-        if (inp_collective_optimization == "baseline") {
-            collectiveOptimization = CollectiveOptimization::Baseline;
-        } else if (inp_collective_optimization == "localBWAware") {
-            collectiveOptimization = CollectiveOptimization::LocalBWAware;
-        } else {
-            sys_panic(
-                "unknown value for collective optimization in sys input file");
-        }
-    }
-    if (j.contains("local-reduction-delay")) {
-        local_reduction_delay = j["local-reduction-delay"];
-    }
-    if (j.contains("active-chunks-per-dimension")) {
-        active_chunks_per_dimension = j["active-chunks-per-dimension"];
-    }
-    if (j.contains("L")) {
-        inp_L = j["L"];
-    }
-    if (j.contains("o")) {
-        inp_o = j["o"];
-    }
-    if (j.contains("g")) {
-        inp_g = j["g"];
-    }
-    if (j.contains("G")) {
-        inp_G = j["G"];
-    }
-    if (j.contains("endpoint-delay")) {
-        communication_delay = j["endpoint-delay"];
+void Sys::initialize_sys(const SystemConfig& config) {
+    if (config.has_scheduling_policy) {
+        this->scheduling_policy = config.scheduling_policy;
+    }
+    all_reduce_implementation_per_dimension = config.all_reduce_implementation;
+    reduce_scatter_implementation_per_dimension =
+        config.reduce_scatter_implementation;
+    all_gather_implementation_per_dimension = config.all_gather_implementation;
+    all_to_all_implementation_per_dimension = config.all_to_all_implementation;
+    // custom collectives read a Chakra ET per rank, so they are not shared
+    if (!config.all_to_all_implementation_custom.empty()) {
+        CollectiveImpl* ci = generate_custom_collective_impl(
+            config.all_to_all_implementation_custom);
+        owned_collective_impls.push_back(ci);
+        all_to_all_implementation_per_dimension = {ci};
+    }
+    if (!config.all_gather_implementation_custom.empty()) {
+        CollectiveImpl* ci = generate_custom_collective_impl(
+            config.all_gather_implementation_custom);
+        owned_collective_impls.push_back(ci);
+        all_gather_implementation_per_dimension = {ci};
+    }
+    if (!config.all_reduce_implementation_custom.empty()) {
+        CollectiveImpl* ci = generate_custom_collective_impl(
+            config.all_reduce_implementation_custom);
+        owned_collective_impls.push_back(ci);
+        all_reduce_implementation_per_dimension = {ci};
+    }
+    if (config.has_collective_optimization) {
+        collectiveOptimization = config.collective_optimization;
+    }
+    local_reduction_delay = config.local_reduction_delay;
+    active_chunks_per_dimension = config.active_chunks_per_dimension;
+    inp_L = config.inp_L;
+    inp_o = config.inp_o;
+    inp_g = config.inp_g;
+    inp_G = config.inp_G;
+    if (config.has_endpoint_delay) {
+        communication_delay = config.endpoint_delay;
         communication_delay = communication_delay * injection_scale;
     }
-    if (j.contains("model-shared-bus")) {
-        int inp_model_shared_bus = j["model-shared-bus"];
-        if (inp_model_shared_bus == 1) {
-            model_shared_bus = true;
-        } else {
-            model_shared_bus = false;
-        }
-    } else {
-        model_shared_bus = false;
-    }
-    if (j.contains("preferred-dataset-splits")) {
-        preferred_dataset_splits = j["preferred-dataset-splits"];
-    }
-    if (j.contains("peak-perf")) {
-        peak_perf = j["peak-perf"];
-        peak_perf = peak_perf * 1000000000000;  // TFLOPS
-    }
-    if (j.contains("local-mem-bw")) {
-        local_mem_bw = j["local-mem-bw"];
-        local_mem_bw = local_mem_bw * 1000000000;  // GB/sec
-    }
-    if (j.contains("roofline-enabled")) {
-        if (j["roofline-enabled"] != 0) {
-            roofline_enabled = true;
-            roofline = new Roofline(local_mem_bw, peak_perf);
-        }
-    }
-    this->trace_enabled = false;
-    if (j.contains("trace-enabled")) {
-        if (j["trace-enabled"] != 0) {
-            this->trace_enabled = true;
-        } else {
-            this->trace_enabled = false;
-        }
-    }
-    this->replay_only = false;
-    if (j.contains("replay-only")) {
-        if (j["replay-only"] != 0) {
-            this->replay_only = true;
-        } else {
-            this->replay_only = false;
-        }
-    }
-
-    inFile.close();
-    return true;
+    model_shared_bus = config.model_shared_bus;
+    preferred_dataset_splits = config.preferred_dataset_splits;
+    peak_perf = config.peak_perf;
+    local_mem_bw = config.local_mem_bw;
+    if (config.roofline_enabled) {
+        roofline_enabled = true;
+        roofline = new Roofline(local_mem_bw, peak_perf);
+    }
+    compute_model = new ComputeModel(config.kernel_table,
+                                     config.compute_scale_rules, compute_scale);
+    this->trace_enabled = config.trace_enabled;
+    this->replay_only = config.replay_only;
+    this->synchronized_scheduling = config.synchronized_scheduling;
+
+    event_store_type = config.event_store_type;
+    event_store_buckets = config.event_store_buckets;
+    lock_guard<mutex> lock(registration_mutex);
+    tick_wheel_enabled = config.global_tick_wheel;
+    if (tick_wheel_enabled && tick_wheel == nullptr) {
+        tick_wheel = new CalendarQueue<int>(config.global_tick_wheel_buckets);
+    }
+    SimProfiler::enabled = config.report_profile;
 }
 
 CollectiveImpl* Sys::generate_collective_impl_from_input(
     string collective_impl_str) {
-    if (collective_impl_str == "ring") {
-        return new CollectiveImpl(CollectiveImplType::Ring);
-    } else if (collective_impl_str == "oneRing") {
-        return new CollectiveImpl(CollectiveImplType::OneRing);
-    } else if (collective_impl_str == "doubleBinaryTree") {
-        return new CollectiveImpl(CollectiveImplType::DoubleBinaryTree);
-    } else if (collective_impl_str.rfind("direct", 0) == 0) {
-        int window = -1;
-        if (collective_impl_str != "direct") {
-            window = stoi(collective_impl_str.substr(6, 5));
-        }
-        return new DirectCollectiveImpl(CollectiveImplType::Direct, window);
-    } else if (collective_impl_str.rfind("oneDirect", 0) == 0) {
-        int window = -1;
-        if (collective_impl_str != "oneDirect") {
-            window = stoi(collective_impl_str.substr(9, 5));
-        }
-        return new DirectCollectiveImpl(CollectiveImplType::OneDirect, window);
-    } else if (collective_impl_str == "halvingDoubling") {
-        return new CollectiveImpl(CollectiveImplType::HalvingDoubling);
-    } else if (collective_impl_str == "oneHalvingDoubling") {
-        return new CollectiveImpl(CollectiveImplType::OneHalvingDoubling);
-    } else if (collective_impl_str == "meshXY") {
-        return new CollectiveImpl(CollectiveImplType::MeshXY);
-    } else {
-        sys_panic("Cannot interpret collective implementations. Please check "
-                  "the collective implementations in the sys"
-                  "input file");
-        return new CollectiveImpl(CollectiveImplType::Ring);
-    }
+    return SystemConfig::parse_collective_impl(collective_impl_str);
 }
 
 CollectiveImpl* Sys::generate_custom_collective_impl(
@@ -542,18 +467,17 @@ CollectiveImpl* Sys::generate_custom_collective_impl(
 }
 
 Tick Sys::boostedTick() {
-    Sys* ts = all_sys[0];
-    if (ts == nullptr) {
-        for (uint64_t i = 1; i < all_sys.size(); i++) {
-            if (all_sys[i] != nullptr) {
-                ts = all_sys[i];
-                break;
-            }
+    return SimClock::now();
+}
+
+int Sys::num_active_sys() {
+    int count = 0;
+    for (auto sys : all_sys) {
+        if (sys != nullptr) {
+            count++;
         }
     }
-    timespec_t tmp = ts->comm_NI->sim_get_time();
-    Tick tick = tmp.time_val / CLOCK_PERIOD;
-    return tick;
+    return count;
 }
 
 void Sys::sys_panic(string msg) {
@@ -567,23 +491,63 @@ void Sys::exit_sim_loop(string msg) {
     logger->warn(msg);
 }
 
+void Sys::check_streamed_workloads() {
+    int unfinished = 0;
+    uint64_t window = 0;
+    for (auto sys : all_sys) {
+        if (sys != nullptr && sys->workload != nullptr &&
+            sys->workload->et_streamed && !sys->workload->is_finished) {
+            unfinished++;
+            window = sys->system_config->workload_window;
+        }
+    }
+    if (unfinished == 0) {
+        return;
+    }
+    LoggerFactory::get_logger("system")->critical(
+        "{} ranks streaming their ET did not finish before the simulation "
+        "ran out of events; a workload-window of {} nodes may not hold the "
+        "nodes other ranks wait on",
+        unfinished, window);
+    exit(EXIT_FAILURE);
+}
+
 void Sys::call(EventType type, CallData* data) {}
 
 void Sys::call_events() {
-    for (auto& callable : event_queue[Sys::boostedTick()]) {
+    Tick current_tick = Sys::boostedTick();
+    SysEvent pending;
+    while (event_store->pop(current_tick, pending)) {
         try {
             pending_events--;
-            (get<0>(callable))->call(get<1>(callable), get<2>(callable));
+            SimProfiler::dispatched_events++;
+            pending.callable->call(pending.event, pending.data);
         } catch (const std::exception& e) {
             auto logger = LoggerFactory::get_logger("system");
             logger->critical("warning! a callable is removed before call {}",
                              e.what());
         }
     }
-    if (event_queue[Sys::boostedTick()].size() > 0) {
-        event_queue[Sys::boostedTick()].clear();
+}
+
+void Sys::call_tick_wheel() {
+    Tick current_tick = Sys::boostedTick();
+    vector<int> ready_sys;
+    int sys_id;
+    tick_wheel_dispatching = true;
+    // Sys objects enrolled while a batch runs form the next batch
+    while (tick_wheel->pop(current_tick, sys_id)) {
+        ready_sys.push_back(sys_id);
+        while (tick_wheel->pop(current_tick, sys_id)) {
+            ready_sys.push_back(sys_id);
+        }
+        sort(ready_sys.begin(), ready_sys.end());
+        for (auto ready_id : ready_sys) {
+            all_sys[ready_id]->call_events();
+        }
+        ready_sys.clear();
     }
-    event_queue.erase(Sys::boostedTick());
+    tick_wheel_dispatching = false;
 }
 
 void Sys::register_event(Callable* callable,
@@ -597,20 +561,25 @@ void Sys::try_register_event(Callable* callable,
                              EventType event,
                              CallData* callData,
                              Tick& delta_cycles) {
-    bool should_schedule = false;
-    auto event_time = Sys::boostedTick() + delta_cycles;
-    if (event_queue.find(event_time) == event_queue.end()) {
-        list<tuple<Callable*, EventType, CallData*>> tmp;
-        event_queue[event_time] = tmp;
-        should_schedule = true;
-    }
-    event_queue[event_time].push_back(make_tuple(callable, event, callData));
+    Tick current_tick = Sys::boostedTick();
+    bool should_schedule =
+        event_store->push(current_tick, current_tick + delta_cycles,
+                          SysEvent{callable, event, callData});
+    if (should_schedule && tick_wheel_enabled) {
+        // the first event of this Sys at that tick enrolls it in the shared
+        // wheel; only the first Sys enrolled at a tick wakes the backend,
+        // unless that tick is the one being dispatched right now
+        should_schedule =
+            tick_wheel->push(current_tick, current_tick + delta_cycles, id) &&
+            !(tick_wheel_dispatching && delta_cycles == 0);
+    }
     if (should_schedule) {
         timespec_t tmp;
         tmp.time_res = NS;
         tmp.time_val = delta_cycles;
-        BasicEventHandlerData* data =
-            new BasicEventHandlerData(id, EventType::CallEvents);
+        BasicEventHandlerData* data = new BasicEventHandlerData(
+            id, tick_wheel_enabled ? EventType::CallTickWheel
+                                   : EventType::CallEvents);
         data->sys_id = id;
         comm_NI->sim_schedule(tmp, &Sys::handleEvent, data);
     }
@@ -621,6 +590,8 @@ void Sys::try_register_event(Callable* callable,
 
 void Sys::handleEvent(void* arg) {
 
+    // the backend has (possibly) advanced its time since the last event
+    SimClock::refresh();
     if (arg == nullptr) {
     // printf("tick %ld empty event\n", Sys::boostedTick());
         return;
@@ -632,10 +603,16 @@ void Sys::handleEvent(void* arg) {
     // printf("tick %ld event %ld\n", Sys::boostedTick(), event);
 
     if (event == EventType::CallEvents) {
+        SimProfiler::backend_wakeups++;
         all_sys[id]->call_events();
         delete ehd;
+    } else if (event == EventType::CallTickWheel) {
+        SimProfiler::backend_wakeups++;
+        call_tick_wheel();
+        delete ehd;
     } else if ((event == EventType::NPU_to_MA) ||
                (event == EventType::MA_to_NPU)) {
+        SimProfiler::backend_wakeups++;
         all_sys[id]->call_events();
     } else if (event == EventType::RendezvousSend) {
         RendezvousSendData* rsd = (RendezvousSendData*)ehd;
@@ -706,12 +683,22 @@ vector<CollectiveImpl*> Sys::get_collective_implementation(ComType comm_type) {
 DataSet* Sys::generate_all_reduce(uint64_t size,
                                   vector<bool> involved_dimensions,
                                   CommunicatorGroup* communicator_group,
-                                  int explicit_priority) {
+                                  int explicit_priority,
+                                int group_x,
+                                int group_y,
+                                int part_x,
+                                int part_y,
+                                bool inter_part) {
     if (communicator_group == nullptr) {
         return generate_collective(size, logical_topologies["AllReduce"],
                                    all_reduce_implementation_per_dimension,
                                    involved_dimensions, ComType::All_Reduce,
-                                   explicit_priority, communicator_group);
+                                   explicit_priority, communicator_group,
+                                    group_x,
+                                    group_y,
+                                    part_x,
+                                    part_y,
+                                    inter_part);
     } else {
         CollectivePlan* plan =
             communicator_group->get_collective_plan(ComType::All_Reduce);
@@ -731,8 +718,7 @@ DataSet* Sys::generate_all_to_all(uint64_t size,
                                 int part_x,
                                 int part_y,
                                 bool inter_part,
-                                std::vector<std::pair<int, int>> alltoall_send_matrix,
-                                std::vector<std::pair<int, int>> alltoall_recv_matrix) {
+                                const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix) {
     if (communicator_group == nullptr) {
         return generate_collective(size, logical_topologies["AllToAll"],
                                    all_to_all_implementation_per_dimension,
@@ -743,8 +729,7 @@ DataSet* Sys::generate_all_to_all(uint64_t size,
                                     part_x,
                                     part_y,
                                     inter_part,
-                                    alltoall_send_matrix,
-                                    alltoall_recv_matrix);
+                                    alltoall_matrix);
     } else {
         CollectivePlan* plan =
             communicator_group->get_collective_plan(ComType::All_to_All);
@@ -826,8 +811,7 @@ DataSet* Sys::generate_collective(
     int part_x,
     int part_y,
     bool inter_part,
-    std::vector<std::pair<int, int>> alltoall_send_matrix,
-    std::vector<std::pair<int, int>> alltoall_recv_matrix) {
+    const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix) {
 
     uint64_t chunk_size = determine_chunk_size(size, collective_type);
     uint64_t recommended_chunk_size = chunk_size;
@@ -914,8 +898,7 @@ DataSet* Sys::generate_collective(
                     part_x,
                     part_y,
                     inter_part,
-                    alltoall_send_matrix,
-                    alltoall_recv_matrix);
+                    alltoall_matrix);
                 vect.push_back(phase);
                 remain_size = phase.final_data_size;
             }
@@ -1104,8 +1087,7 @@ CollectivePhase Sys::generate_collective_phase(
     int part_x,
     int part_y,
     bool inter_part,
-    std::vector<std::pair<int, int>> alltoall_send_matrix,
-    std::vector<std::pair<int, int>> alltoall_recv_matrix) {
+    const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix) {
 
     if (collective_impl->type == CollectiveImplType::Ring ||
         collective_impl->type == CollectiveImplType::OneRing) {
@@ -1151,8 +1133,8 @@ CollectivePhase Sys::generate_collective_phase(
                                                 part_x,
                                                 part_y,
                                                 inter_part,
-                                                alltoall_send_matrix,
-                                                alltoall_recv_matrix));
+                                                system_config->meshxy_sub_chunks(collective_type),
+                                                alltoall_matrix));
         return vn;
     } else {
         LoggerFactory::get_logger("system")->critical(
@@ -1220,6 +1202,7 @@ int Sys::break_dimension(int model_parallel_npu_group) {
             }
             CollectiveImpl* replicate = (CollectiveImpl*)(*it)->clone();
             all_reduce_implementation_per_dimension.insert(it, replicate);
+            owned_collective_impls.push_back(replicate);
 
             it = reduce_scatter_implementation_per_dimension.begin();
             if (reduce_scatter_implementation_per_dimension.size() >
@@ -1231,6 +1214,7 @@ int Sys::break_dimension(int model_parallel_npu_group) {
             }
             replicate = (CollectiveImpl*)(*it)->clone();
             reduce_scatter_implementation_per_dimension.insert(it, replicate);
+            owned_collective_impls.push_back(replicate);
 
             it = all_gather_implementation_per_dimension.begin();
             if (all_gather_implementation_per_dimension.size() >
@@ -1242,6 +1226,7 @@ int Sys::break_dimension(int model_parallel_npu_group) {
             }
             replicate = (CollectiveImpl*)(*it)->clone();
             all_gather_implementation_per_dimension.insert(it, replicate);
+            owned_collective_impls.push_back(replicate);
 
             it = all_to_all_implementation_per_dimension.begin();
             if (all_to_all_implementation_per_dimension.size() >
@@ -1253,6 +1238,7 @@ int Sys::break_dimension(int model_parallel_npu_group) {
             }
             replicate = (CollectiveImpl*)(*it)->clone();
             all_to_all_implementation_per_dimension.insert(it, replicate);
+            owned_collective_impls.push_back(replicate);
             logical_topologies["AllReduce"] = new GeneralComplexTopology(
                 id, logical_dims, all_reduce_implementation_per_dimension);
             logical_topologies["ReduceScatter"] = new GeneralComplexTopology(
@@ -1305,27 +1291,24 @@ int Sys::get_priority(int explicit_priority) {
 
 void Sys::insert_into_ready_list(BaseStream* stream) {
     insert_stream(&ready_list, stream);
+    if (synchronized_scheduling) {
+        // the stream may be the new head even if the scheduler is not
+        // asked to schedule, and the barrier must follow it
+        update_schedule_barrier();
+    }
     scheduler_unit->notify_stream_added_into_ready_list();
 }
 
-void Sys::insert_stream(list<BaseStream*>* queue, BaseStream* baseStream) {
-    list<BaseStream*>::iterator it = queue->begin();
+void Sys::insert_stream(StreamQueue* queue, BaseStream* baseStream) {
     if (intra_dimension_scheduling == IntraDimensionScheduling::FIFO ||
         baseStream->current_queue_id < 0 ||
         baseStream->current_com_type == ComType::All_to_All ||
         baseStream->current_com_type == ComType::All_Reduce) {
-        while (it != queue->end()) {
-            if ((*it)->initialized == true) {
-                advance(it, 1);
-                continue;
-            } else if ((*it)->priority >= baseStream->priority) {
-                advance(it, 1);
-                continue;
-            } else {
-                break;
-            }
-        }
+        // after every waiting stream of higher or equal priority
+        queue->insert_ordered(baseStream, StreamOrder::DescendingPriority,
+                              true);
     } else if (intra_dimension_scheduling == IntraDimensionScheduling::RG) {
+        StreamQueue::iterator it = queue->begin();
         ComType one_to_last = ComType::None;
         ComType last = ComType::None;
         while (it != queue->end()) {
@@ -1352,93 +1335,120 @@ void Sys::insert_stream(list<BaseStream*>* queue, BaseStream* baseStream) {
                 break;
             }
         }
+        queue->insert_at(it, baseStream);
     } else if (intra_dimension_scheduling ==
                IntraDimensionScheduling::SmallestFirst) {
         if (baseStream->phases_to_go.size() == 1) {
-            it = queue->end();
-        }
-        while (it != queue->end()) {
-            if ((*it)->initialized == true) {
-                advance(it, 1);
-                continue;
-            } else if (max((*it)->my_current_phase.initial_data_size,
-                           (*it)->my_current_phase.final_data_size) <
-                       max(baseStream->my_current_phase.initial_data_size,
-                           baseStream->my_current_phase.final_data_size)) {
-                advance(it, 1);
-                continue;
-            } else {
-                break;
-            }
+            queue->append(baseStream, StreamOrder::AscendingSize);
+        } else {
+            // before the first waiting stream that is not smaller
+            queue->insert_ordered(baseStream, StreamOrder::AscendingSize,
+                                  false);
         }
     } else if (intra_dimension_scheduling ==
                IntraDimensionScheduling::LessRemainingPhaseFirst) {
-        while (it != queue->end()) {
-            if ((*it)->initialized == true) {
-                advance(it, 1);
-                continue;
-            } else if ((*it)->phases_to_go.size() <
-                       baseStream->phases_to_go.size()) {
-                advance(it, 1);
-                continue;
-            } else {
-                break;
-            }
-        }
+        // before the first waiting stream with no fewer phases to go
+        queue->insert_ordered(baseStream, StreamOrder::AscendingPhases, false);
     }
-    queue->insert(it, baseStream);
 }
 
 void Sys::ask_for_schedule(int max) {
-    if (ready_list.size() == 0 ||
-        ready_list.front()->synchronizer[ready_list.front()->stream_id] <
-            all_sys.size()) {
+    // Every rank waiting at the barrier is counted in the 'ready' field of
+    // the slot of its ready list's head, so the barrier of a stream id is
+    // complete once that count reaches the number of ranks. Arrivals and
+    // departures are O(1); only a completed barrier walks all ranks.
+    update_schedule_barrier();
+    if (barrier_firing || barrier_slot == -1) {
+        return;
+    }
+    StreamSlot& head = StreamRegistry::slot(barrier_slot);
+    if (head.created < num_sys || head.ready < num_sys) {
         return;
     }
-    int top = ready_list.front()->stream_id;
+    // a rank counted here whose head changed since it arrived has left the
+    // barrier already; wait for all heads to agree
+    for (auto& sys : all_sys) {
+        if (sys == nullptr) {
+            continue;
+        }
+        if (sys->ready_list.size() == 0 ||
+            sys->ready_list.front()->registry_slot != barrier_slot) {
+            return;
+        }
+    }
     uint64_t min = ready_list.size();
     if (min > max) {
         min = static_cast<uint64_t>(max);
     }
+    // leave the barrier before scheduling, the streams may finish (and
+    // their slot be recycled) right away
     for (auto& sys : all_sys) {
-        if (sys->ready_list.size() == 0 ||
-            sys->ready_list.front()->stream_id != top) {
-            return;
+        if (sys == nullptr) {
+            continue;
         }
         if (sys->ready_list.size() < min) {
             min = sys->ready_list.size();
         }
+        sys->barrier_slot = -1;
+    }
+    head.ready = 0;
+    barrier_firing = true;
+    for (auto& sys : all_sys) {
+        if (sys != nullptr) {
+            sys->schedule(min);
+        }
     }
+    barrier_firing = false;
     for (auto& sys : all_sys) {
-        sys->schedule(min);
+        if (sys != nullptr) {
+            sys->update_schedule_barrier();
+        }
     }
     return;
 }
 
+void Sys::update_schedule_barrier() {
+    int head_slot = -1;
+    if (ready_list.size() != 0) {
+        head_slot = ready_list.front()->registry_slot;
+    }
+    if (head_slot == barrier_slot) {
+        return;
+    }
+    if (barrier_slot != -1) {
+        StreamRegistry::slot(barrier_slot).ready--;
+    }
+    if (head_slot != -1) {
+        StreamRegistry::slot(head_slot).ready++;
+    }
+    barrier_slot = head_slot;
+}
+
 void Sys::schedule(int num) {
     int ready_list_size = ready_list.size();
     int counter = min(num, ready_list_size);
     while (counter > 0) {
-        int top_vn = ready_list.front()->phases_to_go.front().queue_id;
+        BaseStream* stream = ready_list.front();
+        int top_vn = stream->phases_to_go.front().queue_id;
         int total_waiting_streams = ready_list.size();
-        int total_phases = ready_list.front()->phases_to_go.size();
+        int total_phases = stream->phases_to_go.size();
 
-        proceed_to_next_vnet_baseline((StreamBaseline*)ready_list.front());
+        // a stream is tracked by one queue at a time: leave the ready list
+        // before moving to the first phase's queue
+        ready_list.pop_front();
+        proceed_to_next_vnet_baseline((StreamBaseline*)stream);
 
-        if (ready_list.front()->current_queue_id == -1) {
+        if (stream->current_queue_id == -1) {
             Sys::sys_panic(
                 "should not happen! " +
-                to_string(
-                    BaseStream::synchronizer[ready_list.front()->stream_id]) +
+                to_string(StreamRegistry::slot(stream->registry_slot).created) +
                 " , " +
-                to_string(
-                    BaseStream::ready_counter[ready_list.front()->stream_id]) +
+                to_string(StreamRegistry::slot(stream->registry_slot).ready) +
                 " , top queue id: " + to_string(top_vn) +
                 " , total phases: " + to_string(total_phases) +
                 " , waiting streams: " + to_string(total_waiting_streams));
         }
 
-        ready_list.pop_front();
         counter--;
         first_phase_streams++;
         total_running_streams++;
@@ -1461,15 +1471,7 @@ void Sys::proceed_to_next_vnet_baseline(StreamBaseline* stream) {
         stream->dataset->notify_stream_finished((StreamStat*)stream);
     }
     if (stream->current_queue_id >= 0 && stream->my_current_phase.enabled) {
-        list<BaseStream*>& target =
-            active_Streams.at(stream->my_current_phase.queue_id);
-        for (list<BaseStream*>::iterator it = target.begin();
-             it != target.end(); ++it) {
-            if (((StreamBaseline*)(*it))->stream_id == stream->stream_id) {
-                target.erase(it);
-                break;
-            }
-        }
+        active_Streams.at(stream->my_current_phase.queue_id).erase(stream);
     }
     if (stream->phases_to_go.size() == 0) {
         total_running_streams--;
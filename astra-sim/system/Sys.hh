@@ -7,14 +7,18 @@ LICENSE file in the root directory of this source tree.
 #define __SYSTEM_HH__
 
 #include <chrono>
+#include <memory>
+#include <mutex>
 
 #include "astra-sim/common/AstraNetworkAPI.hh"
 #include "astra-sim/system/AstraRemoteMemoryAPI.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CollectivePhase.hh"
 #include "astra-sim/system/CommunicatorGroup.hh"
+#include "astra-sim/system/EventStore.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/Roofline.hh"
+#include "astra-sim/system/StreamQueue.hh"
 #include "astra-sim/system/UsageTracker.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/RingTopology.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/MeshTopology.hh"
@@ -23,6 +27,7 @@ LICENSE file in the root directory of this source tree.
 namespace AstraSim {
 
 class BaseStream;
+class ComputeModel;
 class StreamBaseline;
 class DataSet;
 class QueueLevels;
@@ -30,6 +35,7 @@ class Workload;
 class LogicalTopology;
 class BasicLogicalTopology;
 class OfflineGreedy;
+class SystemConfig;
 
 class Sys : public Callable {
   public:
@@ -52,7 +58,6 @@ class Sys : public Callable {
         int ready_list_threshold;
         int queue_threshold;
         std::map<int, int> running_streams;
-        std::map<int, std::list<BaseStream*>::iterator> stream_pointer;
         std::vector<Tick> latency_per_dimension;
         std::vector<double> total_chunks_per_dimension;
         std::vector<uint64_t> total_active_chunks_per_dimension;
@@ -73,13 +78,26 @@ class Sys : public Callable {
         std::vector<int> queues_per_dim,
         double injection_scale,
         double comm_scale,
+        double compute_scale,
+        bool rendezvous_enabled);
+    Sys(int id,
+        std::string workload_configuration,
+        std::string comm_group_configuration,
+        std::shared_ptr<const SystemConfig> system_config,
+        AstraRemoteMemoryAPI* remote_mem,
+        AstraNetworkAPI* comm_NI,
+        std::vector<int> physical_dims,
+        std::vector<int> queues_per_dim,
+        double injection_scale,
+        double comm_scale,
+        double compute_scale,
         bool rendezvous_enabled);
     ~Sys();
     //---------------------------------------------------------------------------
 
     // Intialization
     // ------------------------------------------------------------
-    bool initialize_sys(std::string name);
+    void initialize_sys(const SystemConfig& config);
     CollectiveImpl* generate_collective_impl_from_input(
         std::string collective_impl_str);
     CollectiveImpl* generate_custom_collective_impl(
@@ -89,12 +107,16 @@ class Sys : public Callable {
     // Helper Functions
     // ---------------------------------------------------------
     static Tick boostedTick();
+    static int num_active_sys();
     static void sys_panic(std::string msg);
     //---------------------------------------------------------------------------
 
     // Simulation Loop
     // ----------------------------------------------------------
     void exit_sim_loop(std::string msg);
+    // Called once the event queue has drained; fails if some rank streaming
+    // its ET has not finished, which a too small window can cause.
+    static void check_streamed_workloads();
     //---------------------------------------------------------------------------
 
     // General Event Handling
@@ -110,6 +132,7 @@ class Sys : public Callable {
                             CallData* callData,
                             Tick& delta_cycles);
     static void handleEvent(void* arg);
+    static void call_tick_wheel();
     //---------------------------------------------------------------------------
 
     // Communicator Group Support
@@ -124,7 +147,12 @@ class Sys : public Callable {
     DataSet* generate_all_reduce(uint64_t size,
                                  std::vector<bool> involved_dimensions,
                                  CommunicatorGroup* communicator_group,
-                                 int explicit_priority);
+                                 int explicit_priority,
+                                int group_x = 0,
+                                int group_y = 0,
+                                int part_x = 0,
+                                int part_y = 0,
+                                bool inter_part = false);
     DataSet* generate_all_to_all(uint64_t size,
                                  std::vector<bool> involved_dimensions,
                                  CommunicatorGroup* communicator_group,
@@ -134,8 +162,7 @@ class Sys : public Callable {
                                 int part_x = 0,
                                 int part_y = 0,
                                 bool inter_part = false,
-                                std::vector<std::pair<int, int>> alltoall_send_matrix = std::vector<std::pair<int, int>>{},
-                                std::vector<std::pair<int, int>> alltoall_recv_matrix = std::vector<std::pair<int, int>>{});
+                                const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix = nullptr);
     DataSet* generate_all_gather(uint64_t size,
                                  std::vector<bool> involved_dimensions,
                                  CommunicatorGroup* communicator_group,
@@ -167,8 +194,7 @@ class Sys : public Callable {
         int part_x = 0,
         int part_y = 0,
         bool inter_part = false,
-        std::vector<std::pair<int, int>> alltoall_send_matrix = std::vector<std::pair<int, int>>{},
-        std::vector<std::pair<int, int>> alltoall_recv_matrix = std::vector<std::pair<int, int>>{});
+        const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix = nullptr);
     CollectivePhase generate_collective_phase(ComType collective_type,
                                               BasicLogicalTopology* topology,
                                               uint64_t data_size,
@@ -181,8 +207,7 @@ class Sys : public Callable {
                                                 int part_x = 0,
                                                 int part_y = 0,
                                                 bool inter_part = false,
-                                                std::vector<std::pair<int, int>> alltoall_send_matrix = std::vector<std::pair<int, int>>{},
-                                                std::vector<std::pair<int, int>> alltoall_recv_matrix = std::vector<std::pair<int, int>>{});
+                                                const std::shared_ptr<const AllToAllMatrix>& alltoall_matrix = nullptr);
     int break_dimension(int model_parallel_npu_group);
     //---------------------------------------------------------------------------
 
@@ -191,8 +216,9 @@ class Sys : public Callable {
     uint64_t determine_chunk_size(uint64_t& size, ComType type);
     int get_priority(int explicit_priority);
     void insert_into_ready_list(BaseStream* stream);
-    void insert_stream(std::list<BaseStream*>* queue, BaseStream* baseStream);
+    void insert_stream(StreamQueue* queue, BaseStream* baseStream);
     void ask_for_schedule(int max);
+    void update_schedule_barrier();
     void schedule(int num);
     void proceed_to_next_vnet_baseline(StreamBaseline* stream);
     //---------------------------------------------------------------------------
@@ -276,6 +302,14 @@ class Sys : public Callable {
     //---------------------------------------------------------------------------
 
     static std::vector<Sys*> all_sys;  // vector of all Sys objects
+    // number of Sys objects constructed, i.e. of ranks being simulated;
+    // all_sys may have holes when only some ranks are simulated
+    static int num_sys;
+    // guards the process-wide state a Sys registers into while it is
+    // constructed, as ranks may be constructed concurrently
+    static std::mutex registration_mutex;
+    // other ranks whose results this Sys stands for (representative mode)
+    std::vector<int> represented_ranks;
 
     int id;
     bool initialized;
@@ -287,6 +321,10 @@ class Sys : public Callable {
     bool roofline_enabled;
     double peak_perf;
     Roofline* roofline;
+    // kernel-table lookup and scaling of compute durations
+    ComputeModel* compute_model;
+    // factor of every compute duration
+    double compute_scale;
 
     // memory
     double local_mem_bw;
@@ -324,15 +362,21 @@ class Sys : public Callable {
     int max_running;
 
     // for supporting LIFO
-    std::list<BaseStream*> ready_list;
+    StreamQueue ready_list;
     SchedulingPolicy scheduling_policy;
     int first_phase_streams;
     int total_running_streams;
-    std::map<int, std::list<BaseStream*>> active_Streams;
+    std::map<int, StreamQueue> active_Streams;
     std::map<int, std::list<int>> stream_priorities;
 
-    std::map<Tick, std::list<std::tuple<Callable*, EventType, CallData*>>>
-        event_queue;
+    // pending events
+    EventStoreType event_store_type;
+    uint64_t event_store_buckets;
+    EventStore* event_store;
+    // when enabled, all Sys objects share one backend wake-up per tick
+    static bool tick_wheel_enabled;
+    static bool tick_wheel_dispatching;
+    static CalendarQueue<int>* tick_wheel;
     int total_nodes;
     int dim_to_break;
     std::vector<int> logical_broken_dims;
@@ -348,6 +392,10 @@ class Sys : public Callable {
     std::vector<CollectiveImpl*> reduce_scatter_implementation_per_dimension;
     std::vector<CollectiveImpl*> all_gather_implementation_per_dimension;
     std::vector<CollectiveImpl*> all_to_all_implementation_per_dimension;
+    // shared by all Sys; owns the parsed collective implementations
+    std::shared_ptr<const SystemConfig> system_config;
+    // per-rank implementations (custom collectives, broken dimensions)
+    std::vector<CollectiveImpl*> owned_collective_impls;
     CollectiveOptimization collectiveOptimization;
     Tick last_scheduled_collective;
     bool break_dimension_done;
@@ -358,6 +406,14 @@ class Sys : public Callable {
 
     // skip simulation for all nodes and use current duration
     bool replay_only;
+
+    // when enabled, streams leave the ready lists of all ranks in lockstep
+    // (see ask_for_schedule)
+    bool synchronized_scheduling;
+    // registry slot of the stream this rank waits on at the schedule
+    // barrier, or -1
+    int barrier_slot;
+    static bool barrier_firing;
 };
 
 }  // namespace AstraSim
@@ -0,0 +1,299 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/SystemConfig.hh"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/ComputeModel.hh"
+#include <json/json.hpp>
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+namespace {
+
+void config_panic(const string& msg) {
+    LoggerFactory::get_logger("system")->critical(msg);
+    exit(1);
+}
+
+vector<CollectiveImpl*> parse_collective_impls(const json& j,
+                                               const string& key) {
+    vector<CollectiveImpl*> impls;
+    if (j.contains(key)) {
+        vector<string> collective_impl_str_vec = j[key];
+        for (auto collective_impl_str : collective_impl_str_vec) {
+            impls.push_back(
+                SystemConfig::parse_collective_impl(collective_impl_str));
+        }
+    }
+    return impls;
+}
+
+string parse_custom_collective_impl(const json& j, const string& key) {
+    if (!j.contains(key)) {
+        return "";
+    }
+    vector<string> chakra_filepath_str_vec = j[key];
+    if (chakra_filepath_str_vec.size() != 1) {
+        throw logic_error(
+            "There should be 1 Chakra ET only. In multi-dim collectives, "
+            "that 1 ET file covers all dimensions");
+    }
+    return chakra_filepath_str_vec[0];
+}
+
+// 'file' as given if it exists, else relative to the sys input file
+string resolve_config_path(const string& config_path, const string& file) {
+    if (file.empty() || file[0] == '/' || ifstream(file).good()) {
+        return file;
+    }
+    const auto slash = config_path.find_last_of('/');
+    if (slash == string::npos) {
+        return file;
+    }
+    return config_path.substr(0, slash + 1) + file;
+}
+
+}  // namespace
+
+shared_ptr<const SystemConfig> SystemConfig::load(const string& path) {
+    ifstream inFile;
+    inFile.open(path);
+    if (!inFile) {
+        config_panic("Unable to open file: " + path);
+    }
+
+    json j;
+    inFile >> j;
+    inFile.close();
+
+    auto config = make_shared<SystemConfig>();
+    config->path = path;
+    if (j.contains("scheduling-policy")) {
+        string inp_scheduling_policy = j["scheduling-policy"];
+        config->has_scheduling_policy = true;
+        if (inp_scheduling_policy == "LIFO") {
+            config->scheduling_policy = SchedulingPolicy::LIFO;
+        } else if (inp_scheduling_policy == "FIFO") {
+            config->scheduling_policy = SchedulingPolicy::FIFO;
+        } else if (inp_scheduling_policy == "EXPLICIT") {
+            config->scheduling_policy = SchedulingPolicy::EXPLICIT;
+        } else {
+            config_panic(
+                "unknown value for scheduling policy in sys input file");
+        }
+    }
+    config->all_reduce_implementation =
+        parse_collective_impls(j, "all-reduce-implementation");
+    config->reduce_scatter_implementation =
+        parse_collective_impls(j, "reduce-scatter-implementation");
+    config->all_gather_implementation =
+        parse_collective_impls(j, "all-gather-implementation");
+    config->all_to_all_implementation =
+        parse_collective_impls(j, "all-to-all-implementation");
+    config->all_to_all_implementation_custom =
+        parse_custom_collective_impl(j, "all-to-all-implementation-custom");
+    config->all_gather_implementation_custom =
+        parse_custom_collective_impl(j, "all-gather-implementation-custom");
+    config->all_reduce_implementation_custom =
+        parse_custom_collective_impl(j, "all-reduce-implementation-custom");
+    if (j.contains("collective-optimization")) {
+        string inp_collective_optimization = j["collective-optimization"];
+        config->has_collective_optimization = true;
+        if (inp_collective_optimization == "baseline") {
+            config->collective_optimization = CollectiveOptimization::Baseline;
+        } else if (inp_collective_optimization == "localBWAware") {
+            config->collective_optimization =
+                CollectiveOptimization::LocalBWAware;
+        } else {
+            config_panic(
+                "unknown value for collective optimization in sys input file");
+        }
+    }
+    if (j.contains("local-reduction-delay")) {
+        config->local_reduction_delay = j["local-reduction-delay"];
+    }
+    if (j.contains("active-chunks-per-dimension")) {
+        config->active_chunks_per_dimension = j["active-chunks-per-dimension"];
+    }
+    if (j.contains("L")) {
+        config->inp_L = j["L"];
+    }
+    if (j.contains("o")) {
+        config->inp_o = j["o"];
+    }
+    if (j.contains("g")) {
+        config->inp_g = j["g"];
+    }
+    if (j.contains("G")) {
+        config->inp_G = j["G"];
+    }
+    if (j.contains("endpoint-delay")) {
+        config->has_endpoint_delay = true;
+        config->endpoint_delay = j["endpoint-delay"];
+    }
+    if (j.contains("model-shared-bus")) {
+        int inp_model_shared_bus = j["model-shared-bus"];
+        config->model_shared_bus = (inp_model_shared_bus == 1);
+    }
+    if (j.contains("preferred-dataset-splits")) {
+        config->preferred_dataset_splits = j["preferred-dataset-splits"];
+    }
+    if (j.contains("peak-perf")) {
+        config->peak_perf = j["peak-perf"];
+        config->peak_perf = config->peak_perf * 1000000000000;  // TFLOPS
+    }
+    if (j.contains("local-mem-bw")) {
+        config->local_mem_bw = j["local-mem-bw"];
+        config->local_mem_bw = config->local_mem_bw * 1000000000;  // GB/sec
+    }
+    if (j.contains("roofline-enabled")) {
+        config->roofline_enabled = (j["roofline-enabled"] != 0);
+    }
+    if (j.contains("trace-enabled")) {
+        config->trace_enabled = (j["trace-enabled"] != 0);
+    }
+    if (j.contains("replay-only")) {
+        config->replay_only = (j["replay-only"] != 0);
+    }
+    if (j.contains("synchronized-scheduling")) {
+        config->synchronized_scheduling = (j["synchronized-scheduling"] != 0);
+    }
+    if (j.contains("event-queue")) {
+        string inp_event_queue = j["event-queue"];
+        config->event_store_type = EventStore::parse_type(inp_event_queue);
+    }
+    if (j.contains("event-queue-buckets")) {
+        config->event_store_buckets = j["event-queue-buckets"];
+    }
+    if (j.contains("global-tick-wheel")) {
+        config->global_tick_wheel = (j["global-tick-wheel"] != 0);
+    }
+    if (j.contains("global-tick-wheel-buckets")) {
+        config->global_tick_wheel_buckets = j["global-tick-wheel-buckets"];
+    }
+    if (j.contains("report-profile")) {
+        config->report_profile = (j["report-profile"] != 0);
+    }
+    if (j.contains("workload-cache-dir")) {
+        string inp_workload_cache_dir = j["workload-cache-dir"];
+        config->workload_cache_dir = inp_workload_cache_dir;
+    }
+    if (j.contains("compute-streams")) {
+        config->compute_streams = j["compute-streams"];
+    }
+    if (j.contains("comm-streams")) {
+        config->comm_streams = j["comm-streams"];
+    }
+    if (j.contains("workload-window")) {
+        config->workload_window = j["workload-window"];
+    }
+    if (j.contains("meshxy-sub-chunks")) {
+        // one count for all collectives, or one per collective
+        const json& sub_chunks = j["meshxy-sub-chunks"];
+        if (sub_chunks.is_object()) {
+            config->meshxy_all_reduce_sub_chunks = sub_chunks.value(
+                "all-reduce", config->meshxy_all_reduce_sub_chunks);
+            config->meshxy_reduce_scatter_sub_chunks = sub_chunks.value(
+                "reduce-scatter", config->meshxy_reduce_scatter_sub_chunks);
+            config->meshxy_all_gather_sub_chunks = sub_chunks.value(
+                "all-gather", config->meshxy_all_gather_sub_chunks);
+        } else {
+            config->meshxy_all_reduce_sub_chunks = sub_chunks;
+            config->meshxy_reduce_scatter_sub_chunks = sub_chunks;
+            config->meshxy_all_gather_sub_chunks = sub_chunks;
+        }
+    }
+    if (j.contains("kernel-table")) {
+        string kernel_table = j["kernel-table"];
+        config->kernel_table =
+            KernelTable::load(resolve_config_path(path, kernel_table));
+    }
+    if (j.contains("compute-scale-rules")) {
+        string compute_scale_rules = j["compute-scale-rules"];
+        config->compute_scale_rules = ComputeScaleRules::load(
+            resolve_config_path(path, compute_scale_rules));
+    }
+    return config;
+}
+
+int SystemConfig::meshxy_sub_chunks(ComType type) const {
+    switch (type) {
+    case ComType::All_Reduce:
+        return meshxy_all_reduce_sub_chunks;
+    case ComType::Reduce_Scatter:
+        return meshxy_reduce_scatter_sub_chunks;
+    case ComType::All_Gather:
+        return meshxy_all_gather_sub_chunks;
+    default:
+        return 1;
+    }
+}
+
+bool SystemConfig::uses_meshxy() const {
+    for (const auto* impls :
+         {&all_reduce_implementation, &reduce_scatter_implementation,
+          &all_gather_implementation, &all_to_all_implementation}) {
+        for (const auto* impl : *impls) {
+            if (impl->type == CollectiveImplType::MeshXY) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+CollectiveImpl* SystemConfig::parse_collective_impl(
+    const string& collective_impl_str) {
+    if (collective_impl_str == "ring") {
+        return new CollectiveImpl(CollectiveImplType::Ring);
+    } else if (collective_impl_str == "oneRing") {
+        return new CollectiveImpl(CollectiveImplType::OneRing);
+    } else if (collective_impl_str == "doubleBinaryTree") {
+        return new CollectiveImpl(CollectiveImplType::DoubleBinaryTree);
+    } else if (collective_impl_str.rfind("direct", 0) == 0) {
+        int window = -1;
+        if (collective_impl_str != "direct") {
+            window = stoi(collective_impl_str.substr(6, 5));
+        }
+        return new DirectCollectiveImpl(CollectiveImplType::Direct, window);
+    } else if (collective_impl_str.rfind("oneDirect", 0) == 0) {
+        int window = -1;
+        if (collective_impl_str != "oneDirect") {
+            window = stoi(collective_impl_str.substr(9, 5));
+        }
+        return new DirectCollectiveImpl(CollectiveImplType::OneDirect, window);
+    } else if (collective_impl_str == "halvingDoubling") {
+        return new CollectiveImpl(CollectiveImplType::HalvingDoubling);
+    } else if (collective_impl_str == "oneHalvingDoubling") {
+        return new CollectiveImpl(CollectiveImplType::OneHalvingDoubling);
+    } else if (collective_impl_str == "meshXY") {
+        return new CollectiveImpl(CollectiveImplType::MeshXY);
+    }
+    config_panic("Cannot interpret collective implementations. Please check "
+                 "the collective implementations in the sys"
+                 "input file");
+    return nullptr;
+}
+
+SystemConfig::~SystemConfig() {
+    for (auto ci : all_reduce_implementation) {
+        delete ci;
+    }
+    for (auto ci : reduce_scatter_implementation) {
+        delete ci;
+    }
+    for (auto ci : all_gather_implementation) {
+        delete ci;
+    }
+    for (auto ci : all_to_all_implementation) {
+        delete ci;
+    }
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __SYSTEM_CONFIG_HH__
+#define __SYSTEM_CONFIG_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+#include "astra-sim/system/EventStore.hh"
+
+namespace AstraSim {
+
+class ComputeScaleRules;
+class KernelTable;
+
+// Contents of the sys input file (system.json). It is parsed once by the
+// frontend and shared read-only by every Sys, including the per-dimension
+// collective implementations.
+class SystemConfig {
+  public:
+    static std::shared_ptr<const SystemConfig> load(const std::string& path);
+    static CollectiveImpl* parse_collective_impl(
+        const std::string& collective_impl_str);
+
+    SystemConfig() = default;
+    SystemConfig(const SystemConfig&) = delete;
+    SystemConfig& operator=(const SystemConfig&) = delete;
+    ~SystemConfig();
+
+    std::string path;
+
+    bool has_scheduling_policy = false;
+    SchedulingPolicy scheduling_policy = SchedulingPolicy::LIFO;
+    bool has_collective_optimization = false;
+    CollectiveOptimization collective_optimization =
+        CollectiveOptimization::Baseline;
+
+    // owned by this object, shared by all Sys
+    std::vector<CollectiveImpl*> all_reduce_implementation;
+    std::vector<CollectiveImpl*> reduce_scatter_implementation;
+    std::vector<CollectiveImpl*> all_gather_implementation;
+    std::vector<CollectiveImpl*> all_to_all_implementation;
+    // Chakra ET prefixes of custom collectives; the ET itself is per rank
+    std::string all_reduce_implementation_custom;
+    std::string all_gather_implementation_custom;
+    std::string all_to_all_implementation_custom;
+
+    int local_reduction_delay = 1;
+    int active_chunks_per_dimension = 1;
+    float inp_L = 0;
+    float inp_o = 0;
+    float inp_g = 0;
+    float inp_G = 0;
+    // scaled by the injection scale of each Sys when given
+    bool has_endpoint_delay = false;
+    int endpoint_delay = 10;
+    bool model_shared_bus = false;
+    int preferred_dataset_splits = 0;
+    double peak_perf = 0;     // FLOPS
+    double local_mem_bw = 0;  // bytes/sec
+    bool roofline_enabled = false;
+    // measured kernel durations of compute nodes, none if null
+    std::shared_ptr<const KernelTable> kernel_table;
+    // per node name and type factors of the compute durations, none if null
+    std::shared_ptr<const ComputeScaleRules> compute_scale_rules;
+    bool trace_enabled = false;
+    bool replay_only = false;
+    bool synchronized_scheduling = false;
+
+    EventStoreType event_store_type = EventStoreType::Map;
+    uint64_t event_store_buckets = 256;
+    bool global_tick_wheel = false;
+    uint64_t global_tick_wheel_buckets = 1024;
+    bool report_profile = false;
+    // directory of compiled workload graphs, none if empty
+    std::string workload_cache_dir;
+    // stream Chakra ETs through a window of this many nodes; 0 loads whole
+    // graphs through GraphStore
+    uint64_t workload_window = 0;
+    // concurrent compute and communication streams of every NPU
+    uint32_t compute_streams = 1;
+    uint32_t comm_streams = 1;
+    // sub-chunks each MeshXY collective is pipelined in across its X and Y
+    // phases; 1 runs the phases one after the other
+    int meshxy_all_reduce_sub_chunks = 4;
+    int meshxy_reduce_scatter_sub_chunks = 1;
+    int meshxy_all_gather_sub_chunks = 1;
+
+    int meshxy_sub_chunks(ComType type) const;
+    // whether any collective is implemented by MeshXY
+    bool uses_meshxy() const;
+};
+
+}  // namespace AstraSim
+
+#endif /* __SYSTEM_CONFIG_HH__ */
@@ -0,0 +1,70 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/ThreadPool.hh"
+
+#include <algorithm>
+
+using namespace std;
+using namespace AstraSim;
+
+ThreadPool::ThreadPool(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+    this->pending_tasks = 0;
+    this->stopping = false;
+    for (int i = 0; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(tasks_mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(tasks_mutex);
+        tasks.push(move(task));
+        pending_tasks++;
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(tasks_mutex);
+    tasks_done.wait(lock, [this] { return pending_tasks == 0; });
+}
+
+void ThreadPool::run() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(tasks_mutex);
+            task_available.wait(lock,
+                                [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = move(tasks.front());
+            tasks.pop();
+        }
+        task();
+        {
+            lock_guard<mutex> lock(tasks_mutex);
+            if (--pending_tasks == 0) {
+                tasks_done.notify_all();
+            }
+        }
+    }
+}
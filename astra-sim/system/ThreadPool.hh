@@ -0,0 +1,51 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __THREAD_POOL_HH__
+#define __THREAD_POOL_HH__
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace AstraSim {
+
+// Fixed set of worker threads running submitted tasks. It is only used
+// outside of the simulation loop, e.g. to construct the Sys of every rank
+// in parallel at startup; the simulation itself stays single-threaded.
+class ThreadPool {
+  public:
+    // 'num_threads' <= 0 uses one thread per hardware thread.
+    explicit ThreadPool(int num_threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+    // Block until every submitted task has finished.
+    void wait();
+    int size() const {
+        return static_cast<int>(workers.size());
+    }
+
+  private:
+    void run();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable task_available;
+    std::condition_variable tasks_done;
+    // submitted tasks that have not finished yet
+    int pending_tasks;
+    bool stopping;
+};
+
+}  // namespace AstraSim
+
+#endif /* __THREAD_POOL_HH__ */
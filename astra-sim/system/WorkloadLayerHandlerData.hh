@@ -8,6 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/common/AstraNetworkAPI.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
+#include "astra-sim/system/ObjectPool.hh"
 
 namespace AstraSim {
 
@@ -15,6 +16,8 @@ class Workload;
 
 class WorkloadLayerHandlerData : public BasicEventHandlerData, public MetaData {
   public:
+    ASTRA_SIM_POOLED_OBJECT(WorkloadLayerHandlerData)
+
     int sys_id;
     Workload* workload;
     uint64_t node_id;
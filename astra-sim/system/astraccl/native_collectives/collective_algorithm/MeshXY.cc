@@ -7,6 +7,9 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/PacketBundle.hh"
 #include "astra-sim/system/RecvPacketEventHandlerData.hh"
+#include "astra-sim/system/SimProfiler.hh"
+
+#include <algorithm>
 
 using namespace AstraSim;
 
@@ -26,171 +29,278 @@ static inline int step_id_col_major(int id,
     return nx * mesh_y + ny;   // column-major flatten
 }
 
-static inline int get_tag_from_id(int id, int instance_id) {
-    return (instance_id << 24) + id;
+// messages of different all-reduce stages between the same pair of NPUs
+// are told apart by 'stage'
+static inline int get_tag_from_id(int id, int instance_id, int stage = 0) {
+    return (instance_id << 24) + (stage << 22) + id;
 }
 
 static inline int get_src_from_tag(int tag) {
-    return tag % (1 << 24);
+    return tag % (1 << 22);
 }
 
-MeshXY::MeshXY(ComType type,
-           int id,
-           MeshTopology* mesh_topology,
-           uint64_t data_size,
-           InjectionPolicy injection_policy,
-           int group_x,
-           int group_y,
-           int part_x,
-           int part_y,
-           bool inter_part,
-           std::vector<std::pair<int, int>> alltoall_send_matrix,
-           std::vector<std::pair<int, int>> alltoall_recv_matrix)
-    : Algorithm() {
+// alternate between the two directions, as the X and Y phases send
+static std::vector<int> interleave_sends(const std::vector<int>& first,
+                                         const std::vector<int>& second) {
+    std::vector<int> order;
+    size_t i = 0, j = 0;
+    while (i < first.size() || j < second.size()) {
+        if (j == second.size() || (i < first.size() && i <= j)) {
+            order.push_back(first[i++]);
+        } else {
+            order.push_back(second[j++]);
+        }
+    }
+    return order;
+}
 
-    this->name = Name::MeshXY;
-    this->comType = type;
-    this->id = id;
-    this->logical_topo = mesh_topology;
+namespace {
 
-    this->mesh_x_ = mesh_topology->get_x();
-    this->mesh_y_ = mesh_topology->get_y();
-    this->mesh_i_ = id / this->mesh_y_;
-    this->mesh_j_ = id % this->mesh_y_;
+// notified when the reduction of a message received by a pipelined
+// all-reduce is done
+class MeshXYReduction : public Callable {
+  public:
+    MeshXYReduction(MeshXY* algorithm, int step)
+        : algorithm(algorithm), step(step) {}
 
-    this->group_x_ = group_x;
-    this->group_y_ = group_y;
-    assert(this->mesh_x_ % group_x == 0);
-    assert(this->mesh_y_ % group_y == 0);
-    this->group_i_ = this->mesh_i_ / group_x;
-    this->group_j_ = this->mesh_i_ / group_y;
+    void call(EventType event, CallData* data) override {
+        // the algorithm may exit, so this is the last use of it
+        algorithm->reduced(step, data);
+        delete this;
+    }
 
-    this->part_x_ = part_x;
-    this->part_y_ = part_y;
-    assert(this->group_x_ % part_x == 0);
-    assert(this->group_y_ % part_y == 0);
-    this->part_i_ = (this->mesh_i_ % group_x) / part_x;
-    this->part_j_ = (this->mesh_j_ % group_y) / part_y;
+  private:
+    MeshXY* algorithm;
+    int step;
+};
 
-    assert(type != ComType::All_Reduce);
-    this->inter_part_ = inter_part;
-    // this->in_x_phase_ = true;
+}  // namespace
 
-    this->send_ups_ = std::vector<int>{};
-    this->send_downs_ = std::vector<int>{};
-    this->send_lefts_ = std::vector<int>{};
-    this->send_rights_ = std::vector<int>{};
+std::unordered_map<MeshXY::PlanKey, std::unique_ptr<const MeshXY::NeighborPlan>, MeshXY::PlanKeyHash> MeshXY::plans_;
 
-    this->recv_ups_ = std::unordered_set<int>{};
-    this->recv_downs_ = std::unordered_set<int>{};
-    this->recv_lefts_ = std::unordered_set<int>{};
-    this->recv_rights_ = std::unordered_set<int>{};
+size_t MeshXY::PlanKeyHash::operator()(const PlanKey& key) const {
+    size_t hash = 0;
+    for (int value : {key.mesh_x, key.mesh_y, key.group_x, key.group_y,
+                      key.part_x, key.part_y, (int)key.inter_part, key.rank}) {
+        hash ^= std::hash<int>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) +
+                (hash >> 2);
+    }
+    return hash;
+}
+
+const MeshXY::NeighborPlan* MeshXY::neighbor_plan(const PlanKey& key) {
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+        ++SimProfiler::meshxy_plan_hits;
+        return it->second.get();
+    }
+    ++SimProfiler::meshxy_plans_built;
+
+    int mesh_x = key.mesh_x;
+    int mesh_y = key.mesh_y;
+    int group_x = key.group_x;
+    int group_y = key.group_y;
+    int part_x = key.part_x;
+    int part_y = key.part_y;
+    bool inter_part = key.inter_part;
+    int rank = key.rank;
+    int mesh_i = rank / mesh_y;
+    int mesh_j = rank % mesh_y;
+    int part_i = (mesh_i % group_x) / part_x;
+    int part_j = (mesh_j % group_y) / part_y;
+
+    auto plan = std::make_unique<NeighborPlan>();
+    plan->recv_mask = 0;
+    auto add_recv = [&](Direction dir, int peer) {
+        plan->recv_peers[dir] = peer;
+        plan->recv_mask |= 1 << dir;
+    };
 
     if (inter_part) {
-        int up = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, -part_x * this->part_i_, 0);
-        if (up != this->id) {
-            this->recv_ups_.insert(up);
+        int up = step_id_col_major(rank, mesh_x, mesh_y, -part_x * part_i, 0);
+        if (up != rank) {
+            add_recv(Direction::Up, up);
         }
-        int down = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, part_x * (group_x / part_x - this->part_i_ - 1), 0);
-        if (down != this->id) {
-            this->recv_downs_.insert(down);            
+        int down = step_id_col_major(rank, mesh_x, mesh_y, part_x * (group_x / part_x - part_i - 1), 0);
+        if (down != rank) {
+            add_recv(Direction::Down, down);
         }
-        int left = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, 0, -part_y * this->part_j_);
-        if (left != this->id) {
-            this->recv_lefts_.insert(left);
+        int left = step_id_col_major(rank, mesh_x, mesh_y, 0, -part_y * part_j);
+        if (left != rank) {
+            add_recv(Direction::Left, left);
         }
-        int right = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, 0, part_y * (group_y / part_y - this->part_j_ - 1));
-        if (right != this->id) {
-            this->recv_rights_.insert(right);
+        int right = step_id_col_major(rank, mesh_x, mesh_y, 0, part_y * (group_y / part_y - part_j - 1));
+        if (right != rank) {
+            add_recv(Direction::Right, right);
         }
-        if (this->part_i_ == 0 || this->part_i_ == ((group_x / part_x) - 1)) {
+        if (part_i == 0 || part_i == ((group_x / part_x) - 1)) {
             int step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, -part_x, 0);
-                    step < this->part_i_;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, -part_x, 0)) {
-                this->send_ups_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, -part_x, 0);
+                    step < part_i;
+                    i = step_id_col_major(i, mesh_x, mesh_y, -part_x, 0)) {
+                plan->send_ups.push_back(i);
                 ++step;
             }
             step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, part_x, 0);
-                    step < group_x / part_x - this->part_i_ - 1;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, part_x, 0)) {
-                // printf("debug1 id:%d, type:%d, down push:%d\n", this->id, this->comType, i);
-                this->send_downs_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, part_x, 0);
+                    step < group_x / part_x - part_i - 1;
+                    i = step_id_col_major(i, mesh_x, mesh_y, part_x, 0)) {
+                // printf("debug1 id:%d, down push:%d\n", rank, i);
+                plan->send_downs.push_back(i);
                 ++step;
             }
         }
-        if (this->part_j_ == 0 || this->part_j_ == ((group_y / part_y) - 1)) {        
+        if (part_j == 0 || part_j == ((group_y / part_y) - 1)) {        
             int step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, 0, -part_y);
-                    step < this->part_j_;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, 0, -part_y)) {
-                this->send_lefts_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, 0, -part_y);
+                    step < part_j;
+                    i = step_id_col_major(i, mesh_x, mesh_y, 0, -part_y)) {
+                plan->send_lefts.push_back(i);
                 ++step;
             }
             step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, 0, part_y);
-                    step < group_y / part_y - this->part_j_ - 1;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, 0, part_y)) {
-                this->send_rights_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, 0, part_y);
+                    step < group_y / part_y - part_j - 1;
+                    i = step_id_col_major(i, mesh_x, mesh_y, 0, part_y)) {
+                plan->send_rights.push_back(i);
                 ++step;
             }
         }
     } else {
-        int up = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, -(this->mesh_i_ % part_x), 0);
-        if (up != this->id) {
-            this->recv_ups_.insert(up);
+        int up = step_id_col_major(rank, mesh_x, mesh_y, -(mesh_i % part_x), 0);
+        if (up != rank) {
+            add_recv(Direction::Up, up);
         }
-        int down = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, part_x - (this->mesh_i_ % part_x) - 1, 0);
-        if (down != this->id) {
-            this->recv_downs_.insert(down);            
+        int down = step_id_col_major(rank, mesh_x, mesh_y, part_x - (mesh_i % part_x) - 1, 0);
+        if (down != rank) {
+            add_recv(Direction::Down, down);
         }
-        int left = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, 0, -(this->mesh_j_ % part_y));
-        if (left != this->id) {
-            this->recv_lefts_.insert(left);
+        int left = step_id_col_major(rank, mesh_x, mesh_y, 0, -(mesh_j % part_y));
+        if (left != rank) {
+            add_recv(Direction::Left, left);
         }
-        int right = step_id_col_major(this->id, this->mesh_x_, this->mesh_y_, 0, part_y - (this->mesh_j_ % part_y) - 1);
-        if (right != this->id) {
-            this->recv_rights_.insert(right);
+        int right = step_id_col_major(rank, mesh_x, mesh_y, 0, part_y - (mesh_j % part_y) - 1);
+        if (right != rank) {
+            add_recv(Direction::Right, right);
         }
-        if ((this->mesh_i_ % part_x == 0) || (this->mesh_i_ % part_x) == (part_x - 1)) {
+        if ((mesh_i % part_x == 0) || (mesh_i % part_x) == (part_x - 1)) {
             int step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, -1, 0);
-                    step < (this->mesh_i_ % part_x);
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, -1, 0)) {
-                this->send_ups_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, -1, 0);
+                    step < (mesh_i % part_x);
+                    i = step_id_col_major(i, mesh_x, mesh_y, -1, 0)) {
+                plan->send_ups.push_back(i);
                 ++step;
             }
             step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, 1, 0);
-                    step < part_x - (this->mesh_i_ % part_x) - 1;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, 1, 0)) {
-                this->send_downs_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, 1, 0);
+                    step < part_x - (mesh_i % part_x) - 1;
+                    i = step_id_col_major(i, mesh_x, mesh_y, 1, 0)) {
+                plan->send_downs.push_back(i);
                 ++step;
             }
         }
-        if ((this->mesh_j_ % part_y == 0) || (this->mesh_j_ % part_y) == (part_y - 1)) {
+        if ((mesh_j % part_y == 0) || (mesh_j % part_y) == (part_y - 1)) {
             int step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, 0, -1);
-                    step < (this->mesh_j_ % part_y);
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, 0, -1)) {
-                this->send_lefts_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, 0, -1);
+                    step < (mesh_j % part_y);
+                    i = step_id_col_major(i, mesh_x, mesh_y, 0, -1)) {
+                plan->send_lefts.push_back(i);
                 ++step;
             }
             step = 0;
-            for (int i = step_id_col_major(id, this->mesh_x_, this->mesh_y_, 0, 1);
-                    step < part_y - (this->mesh_j_ % part_y) - 1;
-                    i = step_id_col_major(i, this->mesh_x_, this->mesh_y_, 0, 1)) {
-                this->send_rights_.push_back(i);
+            for (int i = step_id_col_major(rank, mesh_x, mesh_y, 0, 1);
+                    step < part_y - (mesh_j % part_y) - 1;
+                    i = step_id_col_major(i, mesh_x, mesh_y, 0, 1)) {
+                plan->send_rights.push_back(i);
                 ++step;
             }
         }
     }
 
-    // data size is already divided by N or K splits when fed in
-    assert(data_size % (group_x * group_y) == 0);
-    this->x_phase_msg_size_ = data_size / group_x;
-    this->y_phase_msg_size_ = data_size / group_x * group_y;
+    plan->x_send_order = interleave_sends(plan->send_ups, plan->send_downs);
+    plan->y_send_order = interleave_sends(plan->send_lefts, plan->send_rights);
+    for (Direction dir : {Direction::Up, Direction::Down, Direction::Left, Direction::Right}) {
+        if (plan->recv_mask & (1 << dir)) {
+            auto& srcs = (dir == Direction::Up || dir == Direction::Down) ? plan->x_recv_srcs : plan->y_recv_srcs;
+            srcs.push_back(plan->recv_peers[dir]);
+        }
+    }
+    return plans_.emplace(key, std::move(plan)).first->second.get();
+}
+
+MeshXY::MeshXY(ComType type,
+           int id,
+           MeshTopology* mesh_topology,
+           uint64_t data_size,
+           InjectionPolicy injection_policy,
+           int group_x,
+           int group_y,
+           int part_x,
+           int part_y,
+           bool inter_part,
+           int sub_chunks,
+           std::shared_ptr<const AllToAllMatrix> alltoall_matrix)
+    : Algorithm() {
+
+    this->name = Name::MeshXY;
+    this->comType = type;
+    this->id = id;
+    this->logical_topo = mesh_topology;
+
+    this->mesh_x_ = mesh_topology->get_x();
+    this->mesh_y_ = mesh_topology->get_y();
+    this->mesh_i_ = id / this->mesh_y_;
+    this->mesh_j_ = id % this->mesh_y_;
+
+    if (group_x <= 0 || group_y <= 0) {
+        // no EP group given, e.g. a gradient all-reduce: the whole mesh is
+        // one group
+        group_x = this->mesh_x_;
+        group_y = this->mesh_y_;
+        inter_part = false;
+    }
+    if (part_x <= 0 || part_y <= 0) {
+        // of a single partition
+        part_x = group_x;
+        part_y = group_y;
+    }
+    this->data_size = data_size;
+    this->final_data_size = data_size;
+
+    this->group_x_ = group_x;
+    this->group_y_ = group_y;
+    assert(this->mesh_x_ % group_x == 0);
+    assert(this->mesh_y_ % group_y == 0);
+    this->group_i_ = this->mesh_i_ / group_x;
+    this->group_j_ = this->mesh_i_ / group_y;
+
+    this->part_x_ = part_x;
+    this->part_y_ = part_y;
+    assert(this->group_x_ % part_x == 0);
+    assert(this->group_y_ % part_y == 0);
+    this->part_i_ = (this->mesh_i_ % group_x) / part_x;
+    this->part_j_ = (this->mesh_j_ % group_y) / part_y;
+
+    this->inter_part_ = inter_part;
+    // this->in_x_phase_ = true;
+
+    this->plan_ = neighbor_plan({this->mesh_x_, this->mesh_y_, group_x, group_y,
+                                 part_x, part_y, inter_part, id});
+    this->recvs_pending_ = this->plan_->recv_mask;
+
+    // data size is already divided by N or K splits when fed in; gradients
+    // of an all-reduce are not, and are rounded down to whole bytes
+    assert(type == ComType::All_Reduce || data_size % (group_x * group_y) == 0);
+    this->x_phase_msg_size_ = std::max<uint64_t>(1, data_size / group_x);
+    if (type == ComType::All_Reduce) {
+        // the y stages move the slice left by the x reduce-scatter, split
+        // among the group_y peers
+        this->y_phase_msg_size_ =
+            std::max<uint64_t>(1, data_size / (group_x * group_y));
+    } else {
+        this->y_phase_msg_size_ =
+            std::max<uint64_t>(1, data_size / group_x * group_y);
+    }
 
     this->packets_to_up_sent_ = 0;
     this->packets_to_down_sent_ = 0;
@@ -204,15 +314,71 @@ MeshXY::MeshXY(ComType type,
     this->done_alltoall_send_ = false;
     this->done_alltoall_recv_ = false;
 
+    this->sub_chunks_ = 1;
+    this->steps_done_ = 0;
+    this->active_x_steps_ = 0;
+    this->active_y_steps_ = 0;
+    this->last_active_change_ = 0;
+    this->overlap_ticks_ = 0;
+    this->start_tick_ = 0;
+    this->pipelined_ = type == ComType::All_Reduce ||
+                       ((type == ComType::Reduce_Scatter || type == ComType::All_Gather) &&
+                        sub_chunks > 1);
+    if (this->pipelined_) {
+        if (type == ComType::All_Reduce) {
+            this->stages_ = {Stage::ReduceScatterX, Stage::ReduceScatterY,
+                             Stage::AllGatherY, Stage::AllGatherX};
+        } else if (type == ComType::Reduce_Scatter) {
+            this->stages_ = {Stage::ReduceScatterX, Stage::ReduceScatterY};
+        } else {
+            // X first, as the unpipelined all-gather
+            this->stages_ = {Stage::AllGatherX, Stage::AllGatherY};
+        }
+        // at least a byte per sub-chunk in either phase
+        this->sub_chunks_ = static_cast<int>(std::min<uint64_t>(
+            std::max(sub_chunks, 1),
+            std::min(this->x_phase_msg_size_, this->y_phase_msg_size_)));
+        for (int stage = 0; stage < this->stages_.size(); ++stage) {
+            for (int sub_chunk = 0; sub_chunk < this->sub_chunks_; ++sub_chunk) {
+                Step step;
+                step.entered = false;
+                step.done = false;
+                if (stage_is_x(stage)) {
+                    step.sends_left = this->plan_->x_send_order.size();
+                    step.recvs_left = this->plan_->x_recv_srcs.size();
+                } else {
+                    step.sends_left = this->plan_->y_send_order.size();
+                    step.recvs_left = this->plan_->y_recv_srcs.size();
+                }
+                step.recvs_waiting = 0;
+                step.reductions_left = 0;
+                this->steps_.push_back(step);
+            }
+        }
+    }
+
 
     /////////////////////////////////// above are for all-gather and reduce-scatter /////////////////////////////////
     ///////////////////////////////////////////// below are for all-toall ///////////////////////////////////////////
 
-    this->alltoall_send_matrix_ = alltoall_send_matrix;
-    this->alltoall_recv_matrix_ = alltoall_recv_matrix;
+    if (alltoall_matrix == nullptr) {
+        // not an all-to-all: nothing to send or receive peer by peer
+        static const auto no_matrix = std::make_shared<const AllToAllMatrix>();
+        alltoall_matrix = no_matrix;
+    }
+    this->alltoall_matrix_ = std::move(alltoall_matrix);
 
     this->alltoall_packet_sent_ = 0;
     this->alltoall_packet_recved_ = 0;
+    auto has_bytes = [](const std::pair<int, int>& peer) { return peer.second > 0; };
+    this->alltoall_sends_ = std::count_if(this->alltoall_matrix_->send.begin(),
+                                          this->alltoall_matrix_->send.end(), has_bytes);
+    this->alltoall_recvs_ = std::count_if(this->alltoall_matrix_->recv.begin(),
+                                          this->alltoall_matrix_->recv.end(), has_bytes);
+    this->alltoall_send_index_ = 0;
+    this->alltoall_pair_ticks_ = 0;
+    this->alltoall_slowest_ticks_ = 0;
+    this->alltoall_slowest_recv_ = -1;
 
     ++(instance_count_[this->id]);
     this->instance_id_ = instance_count_[this->id];
@@ -324,7 +490,9 @@ MeshXY::MeshXY(ComType type,
 // }
 
 bool MeshXY::all_done() {
-    if (this->comType == ComType::All_to_All) {
+    if (this->pipelined_) {
+        return this->steps_done_ == this->steps_.size();
+    } else if (this->comType == ComType::All_to_All) {
         return this->done_alltoall_send_ && this->done_alltoall_recv_;
     } else {
         return this->done_x_phase_send_ && this->done_x_phase_recv_ && this->done_y_phase_send_ && this->done_y_phase_recv_;
@@ -336,6 +504,11 @@ void MeshXY::run(EventType event, CallData* data) {
     // the flow of sending a packet is call Send_to_MA -> trigger a eventype::General -> call front_end_sim_send
     // the flow of reciving a packet is call front_send_sim_recv -> trigger a eventype: PacketReceived -> call Send_to_NPU
 
+    if (this->pipelined_) {
+        run_pipeline(event, data);
+        return;
+    }
+
     if (event == EventType::General) {
         // seems to be called after a packet is sent from NPU to MA with a end-point delay, likely representing the packet leaves the NPU?
         // free_packets += 1;
@@ -344,43 +517,48 @@ void MeshXY::run(EventType event, CallData* data) {
         // iterable exit the algo if the algo finish
         // iteratable();
         int dst;
-        int msg_size;
+        uint64_t msg_size;
         bool send_msg = true;
 
         if (comType == ComType::All_to_All) {
-            if (this->alltoall_send_matrix_.size() == 0) {
+            const auto& sends = this->alltoall_matrix_->send;
+            if (this->alltoall_sends_ == 0) {
                 // a dummy packet to wake up and exit
                 send_msg = false;
             } else {
-                dst = this->alltoall_send_matrix_[this->alltoall_packet_sent_].first;
-                msg_size = this->alltoall_send_matrix_[this->alltoall_packet_sent_].second;
+                while (sends[this->alltoall_send_index_].second <= 0) {
+                    ++(this->alltoall_send_index_);
+                }
+                dst = sends[this->alltoall_send_index_].first;
+                msg_size = sends[this->alltoall_send_index_].second;
+                ++(this->alltoall_send_index_);
                 ++(this->alltoall_packet_sent_);
             }
-            if (this->alltoall_packet_sent_ == this->alltoall_send_matrix_.size()) {
+            if (this->alltoall_packet_sent_ == this->alltoall_sends_) {
                 this->done_alltoall_send_ = true;
             }
         } else if (!this->done_x_phase_send_) {
             bool send2up;
-            if (this->packets_to_up_sent_ == this->send_ups_.size()) {
+            if (this->packets_to_up_sent_ == this->plan_->send_ups.size()) {
                 send2up = false;
-            } else if (this->packets_to_down_sent_ == this->send_downs_.size()) {
+            } else if (this->packets_to_down_sent_ == this->plan_->send_downs.size()) {
                 send2up = true;
             } else {
                 send2up = this->packets_to_up_sent_ <= this->packets_to_down_sent_;
             }
 
             if (send2up) {
-                dst = this->send_ups_[this->packets_to_up_sent_];
+                dst = this->plan_->send_ups[this->packets_to_up_sent_];
                 ++(this->packets_to_up_sent_);
             } else {
                 // printf("debug2 id: %d, type:%d, in x: %d, done x send: %d, done x recv: %d, done y send: %d, done y recv: %d, send_down idx:%d, size:%d\n", this->id, this->comType, this->in_x_phase_,
-                    // this->done_x_phase_send_, this->done_x_phase_recv_, this->done_y_phase_send_, this->done_y_phase_recv_, this->packets_to_down_sent_, this->send_downs_.size());
-                dst = this->send_downs_[this->packets_to_down_sent_];
+                    // this->done_x_phase_send_, this->done_x_phase_recv_, this->done_y_phase_send_, this->done_y_phase_recv_, this->packets_to_down_sent_, this->plan_->send_downs.size());
+                dst = this->plan_->send_downs[this->packets_to_down_sent_];
                 ++(this->packets_to_down_sent_);
             }
             msg_size = this->x_phase_msg_size_;
 
-            if (this->packets_to_up_sent_ == this->send_ups_.size() && this->packets_to_down_sent_ == this->send_downs_.size()) {
+            if (this->packets_to_up_sent_ == this->plan_->send_ups.size() && this->packets_to_down_sent_ == this->plan_->send_downs.size()) {
                 // all done with x phase send
                 this->done_x_phase_send_ = true;
                 // if (this->done_x_phase_recv_) {
@@ -389,32 +567,32 @@ void MeshXY::run(EventType event, CallData* data) {
             }
         } else {
             bool send2left;
-            if (this->packets_to_left_sent_ == this->send_lefts_.size()) {
+            if (this->packets_to_left_sent_ == this->plan_->send_lefts.size()) {
                 send2left = false;
-            } else if (this->packets_to_right_sent_ == this->send_rights_.size()) {
+            } else if (this->packets_to_right_sent_ == this->plan_->send_rights.size()) {
                 send2left = true;
             } else {
                 send2left = this->packets_to_left_sent_ <= this->packets_to_right_sent_;
             }
 
             if (send2left) {
-                dst = this->send_lefts_[this->packets_to_left_sent_];
+                dst = this->plan_->send_lefts[this->packets_to_left_sent_];
                 ++(this->packets_to_left_sent_);
             } else {
-                // printf("%d %d\n", this->send_rights_.size(), this->packets_to_right_sent_);
-                dst = this->send_rights_[this->packets_to_right_sent_];
+                // printf("%d %d\n", this->plan_->send_rights.size(), this->packets_to_right_sent_);
+                dst = this->plan_->send_rights[this->packets_to_right_sent_];
                 ++(this->packets_to_right_sent_);
             }
             msg_size = this->y_phase_msg_size_;
 
-            if (this->packets_to_left_sent_ == this->send_lefts_.size() && this->packets_to_right_sent_ == this->send_rights_.size()) {
+            if (this->packets_to_left_sent_ == this->plan_->send_lefts.size() && this->packets_to_right_sent_ == this->plan_->send_rights.size()) {
                 // done with y phase send
                 this->done_y_phase_send_ = true;
             }
         }
 
         if (send_msg) {
-            // printf("here %d %d %ld\n", this->id, this->alltoall_packet_sent_, this->alltoall_send_matrix_.size());
+            // printf("here %d %d %ld\n", this->id, this->alltoall_packet_sent_, this->alltoall_matrix_->send.size());
             LoggerFactory::get_logger("system::collective::MeshXY")
                 ->debug("id:{}, instance:{}, send packet to: {}, size: {}",
                     this->id, this->instance_id_, dst, msg_size);
@@ -442,10 +620,10 @@ void MeshXY::run(EventType event, CallData* data) {
         }
 
         // if we don't need to recv we should exit right now
-        // if ((this->comType == ComType::All_to_All && this->alltoall_recv_matrix_.size() == 0)
+        // if ((this->comType == ComType::All_to_All && this->alltoall_matrix_->recv.size() == 0)
         //     || ((this->comType == ComType::All_Gather || this->comType == ComType::Reduce_Scatter)
         //         && !this->in_x_phase_ && this->lefts_.size() == 0 && this->rights_.size() == 0)) {
-        // if (this->comType == ComType::All_to_All && this->alltoall_recv_matrix_.size() == 0) {
+        // if (this->comType == ComType::All_to_All && this->alltoall_matrix_->recv.size() == 0) {
         if (this->all_done()) {
             LoggerFactory::get_logger("system::collective::MeshXY")
                 ->debug("id:{}, skip recv and exit", this->id);
@@ -460,24 +638,32 @@ void MeshXY::run(EventType event, CallData* data) {
 
         // handle recved packets
         if (comType == ComType::All_to_All) {
+            // the tag of an all-to-all recv is its index in the recv matrix
+            src = this->alltoall_matrix_->recv[tag].first;
             ++(this->alltoall_packet_recved_);
+            Tick pair_ticks = Sys::boostedTick() - this->start_tick_;
+            this->alltoall_pair_ticks_ += pair_ticks;
+            if (this->alltoall_slowest_recv_ < 0 || pair_ticks >= this->alltoall_slowest_ticks_) {
+                this->alltoall_slowest_ticks_ = pair_ticks;
+                this->alltoall_slowest_recv_ = tag;
+            }
             LoggerFactory::get_logger("system::collective::MeshXY")
                 ->debug("id:{}, instance:{}, All_to_All recv packet from: {}, total recved: {}, exp recved: {}",
-                    this->id, this->instance_id_, src, this->alltoall_packet_recved_, this->alltoall_recv_matrix_.size());
-            if (this->alltoall_packet_recved_ == this->alltoall_recv_matrix_.size()) {
+                    this->id, this->instance_id_, src, this->alltoall_packet_recved_, this->alltoall_recvs_);
+            if (this->alltoall_packet_recved_ == this->alltoall_recvs_) {
                 LoggerFactory::get_logger("system::collective::MeshXY")
                      ->debug("id:{}, done all_to_all recv and exit", this->id);
                 this->done_alltoall_recv_ = true;
             }
         } else if (!this->done_x_phase_recv_) {
-            bool from_up = this->recv_ups_.find(src) != this->recv_ups_.end();
-            bool from_down = this->recv_downs_.find(src) != this->recv_downs_.end();
+            bool from_up = expects_recv(Direction::Up, src);
+            bool from_down = expects_recv(Direction::Down, src);
             if (from_up) {
                 assert(!from_down);
-                this->recv_ups_.erase(src);
+                this->recvs_pending_ &= ~(1 << Direction::Up);
             } else if (from_down) {
                 assert(!from_up);
-                this->recv_downs_.erase(src);
+                this->recvs_pending_ &= ~(1 << Direction::Down);
             } else{
                 printf("id:%d instance:%d unexpected recv from %d\n", this->id, this->instance_id_, src);
                 assert(0);
@@ -485,15 +671,15 @@ void MeshXY::run(EventType event, CallData* data) {
             LoggerFactory::get_logger("system::collective::MeshXY")
                 ->debug("id:{}, instance:{}, X-phase recv packet from: {}({}), dir to recv: {}, exp dir recved: {}",
                     id, this->instance_id_, src, from_up ? "up" : "down",
-                    from_up ? this->recv_ups_.size() : this->recv_downs_.size(),
+                    (this->recvs_pending_ >> (from_up ? Direction::Up : Direction::Down)) & 1,
                     1);
-            if (this->recv_ups_.size() == 0 && this->recv_downs_.size() == 0) {
+            if ((this->recvs_pending_ & kXRecvs) == 0) {
                 this->done_x_phase_recv_ = true;
                 // if (this->done_x_phase_send_) {
                 //     this->in_x_phase_ = false;
                 // }
                 
-                // if (this->recv_lefts_.size() == 0 && this->recv_rights_.size() == 0) {
+                // if ((this->recvs_pending_ & kYRecvs) == 0) {
                 //     LoggerFactory::get_logger("system::collective::MeshXY")
                 //         ->debug("id:{}, skip Y-phase and exit", this->id);
                 //     exit();
@@ -501,13 +687,7 @@ void MeshXY::run(EventType event, CallData* data) {
                 // }
 
                 // post recv for y phase
-                std::vector<int> recv_srcs;
-                for (const int left: this->recv_lefts_) {
-                    recv_srcs.push_back(left);
-                }
-                for (const int right: this->recv_rights_) {
-                    recv_srcs.push_back(right);
-                }
+                const auto& recv_srcs = this->plan_->y_recv_srcs;
                 if (recv_srcs.size() == 0) {
                     this->done_y_phase_send_ = true;
                     this->done_y_phase_recv_ = true;
@@ -543,7 +723,7 @@ void MeshXY::run(EventType event, CallData* data) {
                 }
 
                 // insert initial packets for the Y phase
-                for (int i = 0; i < this->send_lefts_.size() + this->send_rights_.size(); ++i) {
+                for (int i = 0; i < this->plan_->send_lefts.size() + this->plan_->send_rights.size(); ++i) {
                     (new PacketBundle(
                         stream->owner,
                         stream,
@@ -553,31 +733,31 @@ void MeshXY::run(EventType event, CallData* data) {
                         this->transmition_
                     ))->send_to_MA();
                 }
-                if (this->send_lefts_.size() + this->send_rights_.size() == 0) {
+                if (this->plan_->send_lefts.size() + this->plan_->send_rights.size() == 0) {
                     // no packets to send
                     this->done_y_phase_send_ = true;
                 }
                 LoggerFactory::get_logger("system::collective::MeshXY")
-                    ->debug("id:{}, insert Y-phase init packets, len: {}", this->id, this->send_lefts_.size() + this->send_rights_.size());
+                    ->debug("id:{}, insert Y-phase init packets, len: {}", this->id, this->plan_->send_lefts.size() + this->plan_->send_rights.size());
             }
         } else {
-            bool from_left = this->recv_lefts_.find(src) != this->recv_lefts_.end();
-            bool from_right = this->recv_rights_.find(src) != this->recv_rights_.end();
+            bool from_left = expects_recv(Direction::Left, src);
+            bool from_right = expects_recv(Direction::Right, src);
             if (from_left) {
                 assert(!from_right);
-                this->recv_lefts_.erase(src);
+                this->recvs_pending_ &= ~(1 << Direction::Left);
             } else if (from_right) {
                 assert(!from_left);
-                this->recv_rights_.erase(src);
+                this->recvs_pending_ &= ~(1 << Direction::Right);
             } else{
                 assert(0);
             }
             LoggerFactory::get_logger("system::collective::MeshXY")
                 ->debug("id:{}, instance:{}, Y-phase recv packet from: {}({}), dir to recv: {}, exp dir recved: {}",
                     id, this->instance_id_, src, from_left ? "left" : "right",
-                    from_left ? this->recv_lefts_.size() : this->recv_rights_.size(),
+                    (this->recvs_pending_ >> (from_left ? Direction::Left : Direction::Right)) & 1,
                     1);
-            if (this->recv_lefts_.size() == 0 && this->recv_rights_.size() == 0) {
+            if ((this->recvs_pending_ & kYRecvs) == 0) {
                 LoggerFactory::get_logger("system::collective::MeshXY")
                     ->debug("id:{}, done Y-phase", this->id);
                 // exit();
@@ -613,50 +793,51 @@ void MeshXY::run(EventType event, CallData* data) {
 
         // post recv
         std::vector<int> recv_srcs;
-        std::vector<int> msg_sizes;
+        std::vector<uint64_t> msg_sizes;
+        // handed back on arrival
+        std::vector<int> recv_tags;
 
         if (comType == ComType::All_to_All) {
-            for (int i = 0; i < this->alltoall_recv_matrix_.size(); ++i) {
-                recv_srcs.push_back(this->alltoall_recv_matrix_[i].first);
-                msg_sizes.push_back(this->alltoall_recv_matrix_[i].second);
+            this->start_tick_ = Sys::boostedTick();
+            for (int i = 0; i < this->alltoall_matrix_->recv.size(); ++i) {
+                if (this->alltoall_matrix_->recv[i].second <= 0) {
+                    continue;
+                }
+                recv_srcs.push_back(this->alltoall_matrix_->recv[i].first);
+                msg_sizes.push_back(this->alltoall_matrix_->recv[i].second);
+                recv_tags.push_back(i);
             }
-            if (this->alltoall_recv_matrix_.size() == 0) {
+            if (this->alltoall_recvs_ == 0) {
                 this->done_alltoall_recv_ = true;
             }
         } else {
             // assert(this->in_x_phase_);
-            auto& srcs1 = this->recv_ups_;
-            auto& srcs2 = this->recv_downs_;
-            int msg_size = this->x_phase_msg_size_;
-            // printf("debug3 id:%d up len %d, down len %d\n", this->id, srcs1.size(), srcs2.size());
-            if (srcs1.size() + srcs2.size() == 0) {
+            const std::vector<int>* srcs = &this->plan_->x_recv_srcs;
+            uint64_t msg_size = this->x_phase_msg_size_;
+            if (srcs->size() == 0) {
                 // for any tile, if no packets to recv in X phase,
                 // the only possibility is that the x dim is 1
                 // so we can fast forward to Y phase
                 LoggerFactory::get_logger("system::collective::MeshXY")
                     ->debug("id:{}, fast-forward to Y-phase", this->id);
                 // this->in_x_phase_ = false;
-                srcs1 = this->recv_lefts_;
-                srcs2 = this->recv_rights_;
-                assert(srcs1.size() + srcs2.size() > 0);
+                srcs = &this->plan_->y_recv_srcs;
+                assert(srcs->size() > 0);
                 msg_size = this->y_phase_msg_size_;
                 this->done_x_phase_send_ = true;
                 this->done_x_phase_recv_ = true;
             }
-            for (const int src1: srcs1) {
-                recv_srcs.push_back(src1);
-                msg_sizes.push_back(msg_size);
-            }
-            for (const int src2: srcs2) {
-                recv_srcs.push_back(src2);
+            for (const int src: *srcs) {
+                recv_srcs.push_back(src);
                 msg_sizes.push_back(msg_size);
+                recv_tags.push_back(src);
             }
         }
         LoggerFactory::get_logger("system::collective::MeshXY")
             ->debug("id:{}, post recv init packets, len: {}", this->id, recv_srcs.size());
         for (int i = 0; i < recv_srcs.size(); ++i) {
             int recv_src = recv_srcs[i];
-            int msg_size = msg_sizes[i];
+            uint64_t msg_size = msg_sizes[i];
 
             sim_request rcv_req;
             rcv_req.vnet = this->stream->current_queue_id;
@@ -666,7 +847,7 @@ void MeshXY::run(EventType event, CallData* data) {
                 EventType::PacketReceived,
                 stream->current_queue_id,
                 stream->stream_id,
-                recv_src
+                recv_tags[i]
             );
             stream->owner->front_end_sim_recv(
                 0,
@@ -685,10 +866,12 @@ void MeshXY::run(EventType event, CallData* data) {
         // insert intial packets
         msg_sizes.clear();
         if (comType == ComType::All_to_All) {
-            for (int i = 0; i < this->alltoall_send_matrix_.size(); ++i) {
-                msg_sizes.push_back(this->alltoall_send_matrix_[i].second);
+            for (int i = 0; i < this->alltoall_matrix_->send.size(); ++i) {
+                if (this->alltoall_matrix_->send[i].second > 0) {
+                    msg_sizes.push_back(this->alltoall_matrix_->send[i].second);
+                }
             }
-            if (this->alltoall_send_matrix_.size() == 0) {
+            if (this->alltoall_sends_ == 0) {
                 // inject a dummy packet so that we will get called and exit
                 // printf("id %d insert dummy packet\n", this->id);
                 LoggerFactory::get_logger("system::collective::MeshXY")
@@ -698,7 +881,7 @@ void MeshXY::run(EventType event, CallData* data) {
         } else {
             if (!this->done_x_phase_send_) {
             // if (this->in_x_phase_) {
-                for (int i = 0; i < this->send_ups_.size() + this->send_downs_.size(); ++i) {
+                for (int i = 0; i < this->plan_->send_ups.size() + this->plan_->send_downs.size(); ++i) {
                     msg_sizes.push_back(this->x_phase_msg_size_);
                 }
                 if (msg_sizes.size() == 0) {
@@ -706,7 +889,7 @@ void MeshXY::run(EventType event, CallData* data) {
                     this->done_x_phase_send_ = true;
                 }
             } else {
-                for (int i = 0; i < this->send_lefts_.size() + this->send_rights_.size(); ++i) {
+                for (int i = 0; i < this->plan_->send_lefts.size() + this->plan_->send_rights.size(); ++i) {
                     msg_sizes.push_back(this->y_phase_msg_size_);
                 }           
             }
@@ -878,6 +1061,251 @@ void MeshXY::run(EventType event, CallData* data) {
 //     return;
 // }
 
+bool MeshXY::stage_is_x(int stage) const {
+    return this->stages_[stage] == Stage::ReduceScatterX ||
+           this->stages_[stage] == Stage::AllGatherX;
+}
+
+bool MeshXY::stage_reduces(int stage) const {
+    // as unpipelined, a reduce-scatter on its own charges no reduction
+    return this->comType == ComType::All_Reduce &&
+           (this->stages_[stage] == Stage::ReduceScatterX ||
+            this->stages_[stage] == Stage::ReduceScatterY);
+}
+
+uint64_t MeshXY::step_msg_size(int stage, int sub_chunk) const {
+    uint64_t msg_size = stage_is_x(stage) ? this->x_phase_msg_size_ : this->y_phase_msg_size_;
+    uint64_t sub_chunk_size = msg_size / this->sub_chunks_;
+    if (sub_chunk == this->sub_chunks_ - 1) {
+        sub_chunk_size += msg_size % this->sub_chunks_;
+    }
+    return sub_chunk_size;
+}
+
+void MeshXY::run_pipeline(EventType event, CallData* data) {
+    if (event == EventType::StreamInit) {
+        this->start_tick_ = Sys::boostedTick();
+        this->last_active_change_ = this->start_tick_;
+        post_pipeline_recvs();
+        enter_step(0, 0);
+        if (this->all_done()) {
+            // nothing to exchange: a dummy packet to wake up and exit
+            LoggerFactory::get_logger("system::collective::MeshXY")
+                ->debug("id:{}, inject dummy packet to wakeup and exit", this->id);
+            (new PacketBundle(stream->owner, stream, false, false, 8,
+                              this->transmition_))->send_to_MA();
+        }
+        return;
+    }
+
+    if (event == EventType::General) {
+        if (!this->pending_sends_.empty()) {
+            PendingSend send = this->pending_sends_.front();
+            this->pending_sends_.pop_front();
+            LoggerFactory::get_logger("system::collective::MeshXY")
+                ->debug("id:{}, instance:{}, stage:{}, sub-chunk:{}, send packet to: {}, size: {}",
+                    this->id, this->instance_id_, send.stage, send.sub_chunk, send.dst, send.size);
+
+            sim_request snd_req;
+            snd_req.srcRank = this->id;
+            snd_req.dstRank = send.dst;
+            snd_req.tag = get_tag_from_id(this->id, this->instance_id_, send.stage);
+            snd_req.reqType = UINT8;
+            snd_req.vnet = this->stream->current_queue_id;
+            stream->owner->front_end_sim_send(
+                0,
+                Sys::dummy_data,
+                send.size,
+                UINT8,
+                snd_req.dstRank,
+                snd_req.tag,
+                &snd_req,
+                Sys::FrontEndSendRecvType::COLLECTIVE,
+                &Sys::handleEvent,
+                nullptr
+            );
+            --step(send.stage, send.sub_chunk).sends_left;
+            try_finish_step(send.stage, send.sub_chunk);
+        }
+    } else if (event == EventType::PacketReceived) {
+        auto ehd = (RecvPacketEventHandlerData*)data;
+        int stage = ehd->tag / this->sub_chunks_;
+        int sub_chunk = ehd->tag % this->sub_chunks_;
+        Step& received = step(stage, sub_chunk);
+        --received.recvs_left;
+        LoggerFactory::get_logger("system::collective::MeshXY")
+            ->debug("id:{}, instance:{}, stage:{}, sub-chunk:{}, recv packet, left to recv: {}",
+                this->id, this->instance_id_, stage, sub_chunk, received.recvs_left);
+        if (stage_reduces(stage)) {
+            if (received.entered) {
+                start_reduction(stage, sub_chunk);
+            } else {
+                // reduced with the local data once it is there
+                ++received.recvs_waiting;
+            }
+        }
+        try_finish_step(stage, sub_chunk);
+    }
+
+    if (this->all_done()) {
+        exit();
+    }
+}
+
+void MeshXY::post_pipeline_recvs() {
+    // in the order the peers send, so that messages of the same stage match
+    // the receives of their sub-chunk
+    for (int stage = 0; stage < this->stages_.size(); ++stage) {
+        const auto& recv_srcs = stage_is_x(stage) ? this->plan_->x_recv_srcs : this->plan_->y_recv_srcs;
+        for (int sub_chunk = 0; sub_chunk < this->sub_chunks_; ++sub_chunk) {
+            for (const int recv_src : recv_srcs) {
+                sim_request rcv_req;
+                rcv_req.vnet = this->stream->current_queue_id;
+                RecvPacketEventHandlerData* ehd = new RecvPacketEventHandlerData(
+                    stream,
+                    stream->owner->id,
+                    EventType::PacketReceived,
+                    stream->current_queue_id,
+                    stream->stream_id,
+                    stage * this->sub_chunks_ + sub_chunk
+                );
+                stream->owner->front_end_sim_recv(
+                    0,
+                    Sys::dummy_data,
+                    step_msg_size(stage, sub_chunk),
+                    UINT8,
+                    recv_src,
+                    get_tag_from_id(recv_src, this->instance_id_, stage),
+                    &rcv_req,
+                    Sys::FrontEndSendRecvType::COLLECTIVE,
+                    &Sys::handleEvent,
+                    ehd
+                );
+            }
+        }
+    }
+}
+
+void MeshXY::enter_step(int stage, int sub_chunk) {
+    Step& entered = step(stage, sub_chunk);
+    entered.entered = true;
+    count_active(stage_is_x(stage), 1);
+    LoggerFactory::get_logger("system::collective::MeshXY")
+        ->debug("id:{}, instance:{}, sub-chunk:{} enters stage:{}",
+            this->id, this->instance_id_, sub_chunk, stage);
+
+    const auto& dsts = stage_is_x(stage) ? this->plan_->x_send_order : this->plan_->y_send_order;
+    uint64_t msg_size = step_msg_size(stage, sub_chunk);
+    for (const int dst : dsts) {
+        this->pending_sends_.push_back({dst, msg_size, stage, sub_chunk});
+        (new PacketBundle(
+            stream->owner,
+            stream,
+            false, // no need to process, the data is local
+            false,
+            msg_size,
+            this->transmition_
+        ))->send_to_MA();
+    }
+    for (; entered.recvs_waiting > 0; --entered.recvs_waiting) {
+        start_reduction(stage, sub_chunk);
+    }
+    try_finish_step(stage, sub_chunk);
+}
+
+void MeshXY::try_finish_step(int stage, int sub_chunk) {
+    Step& finished = step(stage, sub_chunk);
+    if (!finished.entered || finished.done || finished.sends_left > 0 ||
+        finished.recvs_left > 0 || finished.reductions_left > 0) {
+        return;
+    }
+    finished.done = true;
+    ++(this->steps_done_);
+    count_active(stage_is_x(stage), -1);
+
+    // this sub-chunk goes on once the one before it left the next stage
+    if (stage + 1 < this->stages_.size() &&
+        (sub_chunk == 0 || step(stage + 1, sub_chunk - 1).done)) {
+        enter_step(stage + 1, sub_chunk);
+    }
+    // and the next sub-chunk follows it once it left the previous stage
+    if (sub_chunk + 1 < this->sub_chunks_ &&
+        (stage == 0 || step(stage - 1, sub_chunk + 1).done)) {
+        enter_step(stage, sub_chunk + 1);
+    }
+}
+
+void MeshXY::count_active(bool x, int delta) {
+    Tick now = Sys::boostedTick();
+    if (this->active_x_steps_ > 0 && this->active_y_steps_ > 0) {
+        this->overlap_ticks_ += now - this->last_active_change_;
+    }
+    this->last_active_change_ = now;
+    if (x) {
+        this->active_x_steps_ += delta;
+    } else {
+        this->active_y_steps_ += delta;
+    }
+}
+
+void MeshXY::start_reduction(int stage, int sub_chunk) {
+    // charged as the processing of a received packet on the memory bus
+    ++step(stage, sub_chunk).reductions_left;
+    PacketBundle* bundle = new PacketBundle(
+        stream->owner,
+        stream,
+        true,
+        false,
+        step_msg_size(stage, sub_chunk),
+        this->transmition_
+    );
+    bundle->notifier = new MeshXYReduction(this, stage * this->sub_chunks_ + sub_chunk);
+    bundle->send_to_NPU();
+}
+
+void MeshXY::reduced(int step_index, CallData* data) {
+    if (data != nullptr) {
+        SharedBusStat* sharedBusStat = (SharedBusStat*)data;
+        stream->update_bus_stats(BusType::Both, sharedBusStat);
+        delete sharedBusStat;
+    }
+    int stage = step_index / this->sub_chunks_;
+    int sub_chunk = step_index % this->sub_chunks_;
+    --step(stage, sub_chunk).reductions_left;
+    try_finish_step(stage, sub_chunk);
+    if (this->all_done()) {
+        exit();
+    }
+}
+
 void MeshXY::exit() {
+    if (this->pipelined_) {
+        Tick phase_ticks = Sys::boostedTick() - this->start_tick_;
+        LoggerFactory::get_logger("system::collective::MeshXY")
+            ->debug("id:{}, instance:{}, type:{}, {} sub-chunks done in {} ticks, X and Y busy together for {}",
+                this->id, this->instance_id_, (int)(this->comType),
+                this->sub_chunks_, phase_ticks, this->overlap_ticks_);
+        ++SimProfiler::meshxy_pipelined_phases;
+        SimProfiler::meshxy_sub_chunks += this->sub_chunks_;
+        SimProfiler::meshxy_phase_ticks += phase_ticks;
+        SimProfiler::meshxy_overlap_ticks += this->overlap_ticks_;
+    } else if (this->comType == ComType::All_to_All && this->alltoall_recvs_ > 0) {
+        const auto& slowest = this->alltoall_matrix_->recv[this->alltoall_slowest_recv_];
+        LoggerFactory::get_logger("system::collective::MeshXY")
+            ->debug("id:{}, instance:{}, All_to_All {} pairs received, {:.1f} ticks per pair on average, slowest from {} ({} bytes) in {} ticks",
+                this->id, this->instance_id_, this->alltoall_recvs_,
+                (double)this->alltoall_pair_ticks_ / this->alltoall_recvs_,
+                slowest.first, slowest.second, this->alltoall_slowest_ticks_);
+        ++SimProfiler::alltoall_phases;
+        SimProfiler::alltoall_pairs += this->alltoall_recvs_;
+        SimProfiler::alltoall_pair_ticks += this->alltoall_pair_ticks_;
+        SimProfiler::alltoall_slowest_pair_ticks += this->alltoall_slowest_ticks_;
+        if (this->alltoall_slowest_ticks_ >= SimProfiler::alltoall_worst_ticks) {
+            SimProfiler::alltoall_worst_ticks = this->alltoall_slowest_ticks_;
+            SimProfiler::alltoall_worst_src = slowest.first;
+            SimProfiler::alltoall_worst_dst = this->id;
+            SimProfiler::alltoall_worst_bytes = slowest.second;
+        }
+    }
     stream->owner->proceed_to_next_vnet_baseline((StreamBaseline*)stream);
 }
@@ -12,7 +12,8 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/MeshTopology.hh"
 #include "astra-sim/common/Logging.hh"
 
-#include <unordered_set>
+#include <deque>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -30,8 +31,8 @@ class MeshXY : public Algorithm {
          int part_x,
          int part_y,
          bool inter_part,
-         std::vector<std::pair<int, int>> alltoall_send_matrix,
-         std::vector<std::pair<int, int>> alltoall_recv_matrix);
+         int sub_chunks,
+         std::shared_ptr<const AllToAllMatrix> alltoall_matrix);
 
     virtual void run(EventType event, CallData* data);
 
@@ -47,6 +48,11 @@ class MeshXY : public Algorithm {
 
     bool all_done();
 
+    // pipelined all-reduce, or reduce-scatter and all-gather in sub-chunks
+    void run_pipeline(EventType event, CallData* data);
+    // a reduction of a message received in 'step' is done
+    void reduced(int step, CallData* data);
+
     // RingTopology::Direction dimension;
     // RingTopology::Direction direction;
     MemBus::Transmition transmition_;
@@ -92,29 +98,77 @@ class MeshXY : public Algorithm {
     
     // bool in_x_phase_;
 
-    std::vector<int> send_ups_;
-    std::vector<int> send_downs_;
-    std::vector<int> send_lefts_;
-    std::vector<int> send_rights_;
-    
-    std::unordered_set<int> recv_ups_;
-    std::unordered_set<int> recv_downs_;
-    std::unordered_set<int> recv_lefts_;
-    std::unordered_set<int> recv_rights_;
-    
-    int x_phase_msg_size_;
-    int y_phase_msg_size_;
+    enum Direction { Up = 0, Down, Left, Right };
+    // whom an NPU sends to and receives from in the X and Y phases. It only
+    // depends on the mesh, group, partition and rank, so it is built once
+    // and shared by all the instances of the same shape on a rank.
+    struct NeighborPlan {
+        std::vector<int> send_ups;
+        std::vector<int> send_downs;
+        std::vector<int> send_lefts;
+        std::vector<int> send_rights;
+        // X and Y destinations in sending order
+        std::vector<int> x_send_order;
+        std::vector<int> y_send_order;
+        // the peer received from in each direction, if its bit is set in
+        // recv_mask
+        int recv_peers[4];
+        uint8_t recv_mask;
+        // the peers received from, up then down and left then right
+        std::vector<int> x_recv_srcs;
+        std::vector<int> y_recv_srcs;
+    };
+    struct PlanKey {
+        int mesh_x, mesh_y;
+        int group_x, group_y;
+        int part_x, part_y;
+        bool inter_part;
+        int rank;
+        bool operator==(const PlanKey& other) const {
+            return mesh_x == other.mesh_x && mesh_y == other.mesh_y &&
+                   group_x == other.group_x && group_y == other.group_y &&
+                   part_x == other.part_x && part_y == other.part_y &&
+                   inter_part == other.inter_part && rank == other.rank;
+        }
+    };
+    struct PlanKeyHash {
+        size_t operator()(const PlanKey& key) const;
+    };
+    static const NeighborPlan* neighbor_plan(const PlanKey& key);
+    static std::unordered_map<PlanKey, std::unique_ptr<const NeighborPlan>, PlanKeyHash> plans_;
+
+    const NeighborPlan* plan_;
+    // directions still to receive from in the current phase, one bit each
+    uint8_t recvs_pending_;
+    static constexpr uint8_t kXRecvs = (1 << Up) | (1 << Down);
+    static constexpr uint8_t kYRecvs = (1 << Left) | (1 << Right);
+    // if a message from 'src' is expected from direction 'dir'
+    bool expects_recv(Direction dir, int src) const {
+        return (this->recvs_pending_ & (1 << dir)) && this->plan_->recv_peers[dir] == src;
+    }
+
+    uint64_t x_phase_msg_size_;
+    uint64_t y_phase_msg_size_;
 
     int packets_to_up_sent_;
     int packets_to_down_sent_;
     int packets_to_left_sent_;
     int packets_to_right_sent_;
 
-    std::vector<std::pair<int, int>> alltoall_send_matrix_;
-    std::vector<std::pair<int, int>> alltoall_recv_matrix_;
+    // shared with the other chunks and phases of the all-to-all, not copied
+    std::shared_ptr<const AllToAllMatrix> alltoall_matrix_;
 
     int alltoall_packet_sent_;
     int alltoall_packet_recved_;
+    // peers with no bytes for each other exchange no message, so skewed
+    // routing only sends to and receives from the peers it has traffic for
+    int alltoall_sends_;
+    int alltoall_recvs_;
+    int alltoall_send_index_;
+    // ticks until the received pairs arrived, summed, and the slowest one
+    Tick alltoall_pair_ticks_;
+    Tick alltoall_slowest_ticks_;
+    int alltoall_slowest_recv_;
 
     bool done_x_phase_send_;
     bool done_x_phase_recv_;
@@ -125,6 +179,58 @@ class MeshXY : public Algorithm {
 
     int instance_id_;
     static std::unordered_map<int, int> instance_count_;
+
+    // All-reduce runs as a reduce-scatter in X, then in Y, and an
+    // all-gather in Y, then in X. The data is split into sub-chunks that go
+    // through these stages in order, so that e.g. the Y reduce-scatter of a
+    // sub-chunk overlaps the X reduce-scatter of the next one. A sub-chunk
+    // enters a stage once it is done with the previous stage and the
+    // sub-chunk before it is done with this one. Reduce-scatter and
+    // all-gather split into more than one sub-chunk run the same way through
+    // their X and Y phases.
+    enum class Stage { ReduceScatterX = 0, ReduceScatterY, AllGatherY, AllGatherX };
+    // one sub-chunk in one stage
+    struct Step {
+        bool entered;
+        bool done;
+        int sends_left;
+        int recvs_left;
+        // received before the step was entered, not reduced yet
+        int recvs_waiting;
+        int reductions_left;
+    };
+    struct PendingSend {
+        int dst;
+        uint64_t size;
+        int stage;
+        int sub_chunk;
+    };
+
+    bool stage_is_x(int stage) const;
+    bool stage_reduces(int stage) const;
+    uint64_t step_msg_size(int stage, int sub_chunk) const;
+    void post_pipeline_recvs();
+    void enter_step(int stage, int sub_chunk);
+    void try_finish_step(int stage, int sub_chunk);
+    void start_reduction(int stage, int sub_chunk);
+    // a step along 'x' or Y became active (+1) or inactive (-1)
+    void count_active(bool x, int delta);
+    Step& step(int stage, int sub_chunk) {
+        return steps_[stage * sub_chunks_ + sub_chunk];
+    }
+
+    bool pipelined_;
+    std::vector<Stage> stages_;
+    int sub_chunks_;
+    std::vector<Step> steps_;
+    int steps_done_;
+    std::deque<PendingSend> pending_sends_;
+    // steps in progress along X and Y, and for how long both axes were busy
+    int active_x_steps_;
+    int active_y_steps_;
+    Tick last_active_change_;
+    Tick overlap_ticks_;
+    Tick start_tick_;
 };
 
 }  // namespace AstraSim
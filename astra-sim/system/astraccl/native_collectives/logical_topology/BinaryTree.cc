@@ -11,6 +11,10 @@ LICENSE file in the root directory of this source tree.
 using namespace std;
 using namespace AstraSim;
 
+mutex BinaryTree::shared_trees_mutex;
+map<tuple<BinaryTree::TreeType, int, int, int>, unique_ptr<BinaryTree>>
+    BinaryTree::shared_trees;
+
 BinaryTree::BinaryTree(
     int id, TreeType tree_type, int total_tree_nodes, int start, int stride)
     : BasicLogicalTopology(BasicLogicalTopology::BasicTopology::BinaryTree) {
@@ -39,6 +43,23 @@ BinaryTree::~BinaryTree() {
     }
 }
 
+BinaryTree* BinaryTree::get_shared(TreeType tree_type,
+                                   int total_tree_nodes,
+                                   int start,
+                                   int stride) {
+    lock_guard<mutex> lock(shared_trees_mutex);
+    auto key = make_tuple(tree_type, total_tree_nodes, start, stride);
+    auto it = shared_trees.find(key);
+    if (it == shared_trees.end()) {
+        it = shared_trees
+                 .emplace(key, make_unique<BinaryTree>(-1, tree_type,
+                                                       total_tree_nodes,
+                                                       start, stride))
+                 .first;
+    }
+    return it->second.get();
+}
+
 Node* BinaryTree::initialize_tree(int depth, Node* parent) {
     Node* tmp = new Node(-1, parent, nullptr, nullptr);
     if (depth > 1) {
@@ -62,7 +83,7 @@ void BinaryTree::build_tree(Node* node) {
 }
 
 int BinaryTree::get_parent_id(int id) {
-    Node* parent = this->node_list[id]->parent;
+    Node* parent = this->node_list.at(id)->parent;
     if (parent != nullptr) {
         return parent->id;
     }
@@ -70,7 +91,7 @@ int BinaryTree::get_parent_id(int id) {
 }
 
 int BinaryTree::get_right_child_id(int id) {
-    Node* child = this->node_list[id]->right_child;
+    Node* child = this->node_list.at(id)->right_child;
     if (child != nullptr) {
         return child->id;
     }
@@ -78,7 +99,7 @@ int BinaryTree::get_right_child_id(int id) {
 }
 
 int BinaryTree::get_left_child_id(int id) {
-    Node* child = this->node_list[id]->left_child;
+    Node* child = this->node_list.at(id)->left_child;
     if (child != nullptr) {
         return child->id;
     }
@@ -86,7 +107,7 @@ int BinaryTree::get_left_child_id(int id) {
 }
 
 BinaryTree::Type BinaryTree::get_node_type(int id) {
-    Node* node = this->node_list[id];
+    Node* node = this->node_list.at(id);
     if (node->parent == nullptr) {
         return Type::Root;
     } else if (node->left_child == nullptr && node->right_child == nullptr) {
@@ -7,6 +7,9 @@ LICENSE file in the root directory of this source tree.
 #define __BINARY_TREE_HH__
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 #include "astra-sim/system/Common.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/BasicLogicalTopology.hh"
@@ -26,6 +29,13 @@ class BinaryTree : public BasicLogicalTopology {
                int stride);
     virtual ~BinaryTree();
 
+    // A tree only depends on its shape, not on the rank querying it, so all
+    // ranks share one process-wide instance per shape.
+    static BinaryTree* get_shared(TreeType tree_type,
+                                  int total_tree_nodes,
+                                  int start,
+                                  int stride);
+
     int get_num_of_nodes_in_dimension(int dimension) override {
         return total_tree_nodes;
     }
@@ -44,6 +54,12 @@ class BinaryTree : public BasicLogicalTopology {
     int stride;
     Node* tree;
     std::map<int, Node*> node_list;
+
+  private:
+    static std::mutex shared_trees_mutex;
+    static std::map<std::tuple<TreeType, int, int, int>,
+                    std::unique_ptr<BinaryTree>>
+        shared_trees;
 };
 
 }  // namespace AstraSim
@@ -11,16 +11,15 @@ DoubleBinaryTreeTopology::DoubleBinaryTreeTopology(int id,
                                                    int total_tree_nodes,
                                                    int start,
                                                    int stride) {
-    DBMAX = new BinaryTree(id, BinaryTree::TreeType::RootMax, total_tree_nodes,
-                           start, stride);
-    DBMIN = new BinaryTree(id, BinaryTree::TreeType::RootMin, total_tree_nodes,
-                           start, stride);
+    DBMAX = BinaryTree::get_shared(BinaryTree::TreeType::RootMax,
+                                   total_tree_nodes, start, stride);
+    DBMIN = BinaryTree::get_shared(BinaryTree::TreeType::RootMin,
+                                   total_tree_nodes, start, stride);
     this->counter = 0;
 }
 
 DoubleBinaryTreeTopology::~DoubleBinaryTreeTopology() {
-    delete DBMIN;
-    delete DBMAX;
+    // DBMAX and DBMIN are shared by all ranks, see BinaryTree::get_shared
 }
 
 LogicalTopology* DoubleBinaryTreeTopology::get_topology() {
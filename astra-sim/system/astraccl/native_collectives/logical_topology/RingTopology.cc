@@ -26,8 +26,8 @@ RingTopology::RingTopology(Dimension dimension, int id, std::vector<int> NPUs)
     this->offset = -1;
     this->index_in_ring = -1;
     for (int i = 0; i < total_nodes_in_ring; i++) {
-        id_to_index[NPUs[i]] = i;
-        index_to_id[i] = NPUs[i];
+        custom_id_to_index[NPUs[i]] = i;
+        custom_index_to_id[i] = NPUs[i];
         if (id == NPUs[i]) {
             index_in_ring = i;
         }
@@ -66,94 +66,66 @@ RingTopology::RingTopology(Dimension dimension,
     this->dimension = dimension;
     this->offset = offset;
 
-    id_to_index[id] = index_in_ring;
-    index_to_id[index_in_ring] = id;
-    int tmp = id;
-    for (int i = 0; i < total_nodes_in_ring - 1; i++) {
-        tmp = get_receiver_homogeneous(tmp, RingTopology::Direction::Clockwise,
-                                       offset);
+    // the ring must not wrap below node 0
+    int first_id = id - index_in_ring * offset;
+    if (first_id < 0) {
+        LoggerFactory::get_logger("system::topology::RingTopology")
+            ->critical("at dim: {} at id: {} index_in_ring {} offset: {}, "
+                       "first node of the ring {}",
+                       name, id, index_in_ring, offset, first_id);
     }
+    assert(first_id >= 0);
 }
 
-int RingTopology::get_receiver_homogeneous(int node_id,
-                                           Direction direction,
-                                           int offset) {
-    assert(id_to_index.find(node_id) != id_to_index.end());
-    int index = id_to_index[node_id];
-    if (direction == RingTopology::Direction::Clockwise) {
-        int receiver = node_id + offset;
-        if (index == total_nodes_in_ring - 1) {
-            receiver -= (total_nodes_in_ring * offset);
-            index = 0;
-        } else {
-            index++;
-        }
-        if (receiver < 0) {
-            LoggerFactory::get_logger("system::topology::RingTopology")
-                ->critical("at dim: {} at id: {} dimension: {} index: {}, node "
-                           "id: {}, offset: {}, index_in_ring {} receiver {}",
-                           name, id, name, index, node_id, offset,
-                           index_in_ring, receiver);
-        }
-        assert(receiver >= 0);
-        id_to_index[receiver] = index;
-        index_to_id[index] = receiver;
-        return receiver;
-    } else {
-        int receiver = node_id - offset;
-        if (index == 0) {
-            receiver += (total_nodes_in_ring * offset);
-            index = total_nodes_in_ring - 1;
-        } else {
-            index--;
-        }
-        if (receiver < 0) {
-            LoggerFactory::get_logger("system::topology::RingTopology")
-                ->critical("at dim: {} at id: {} dimension: {} index: {}, node "
-                           "id: {}, offset: {}, index_in_ring {} receiver {}",
-                           name, id, name, index, node_id, offset,
-                           index_in_ring, receiver);
-        }
-        assert(receiver >= 0);
-        id_to_index[receiver] = index;
-        index_to_id[index] = receiver;
-        return receiver;
+int RingTopology::id_to_index(int node_id) {
+    if (offset < 0) {
+        assert(custom_id_to_index.find(node_id) != custom_id_to_index.end());
+        return custom_id_to_index[node_id];
+    }
+    assert((node_id - id) % offset == 0);
+    int index = index_in_ring + (node_id - id) / offset;
+    assert(index >= 0 && index < total_nodes_in_ring);
+    return index;
+}
+
+int RingTopology::index_to_id(int index) {
+    if (offset < 0) {
+        return custom_index_to_id[index];
     }
+    return id + (index - index_in_ring) * offset;
 }
 
 int RingTopology::get_receiver(int node_id, Direction direction) {
-    assert(id_to_index.find(node_id) != id_to_index.end());
-    int index = id_to_index[node_id];
+    int index = id_to_index(node_id);
     if (direction == RingTopology::Direction::Clockwise) {
         index++;
         if (index == total_nodes_in_ring) {
             index = 0;
         }
-        return index_to_id[index];
+        return index_to_id(index);
     } else {
         index--;
         if (index < 0) {
             index = total_nodes_in_ring - 1;
         }
-        return index_to_id[index];
+        return index_to_id(index);
     }
 }
 
 int RingTopology::get_sender(int node_id, Direction direction) {
-    assert(id_to_index.find(node_id) != id_to_index.end());
-    int index = id_to_index[node_id];
+    int index = id_to_index(node_id);
     if (direction == RingTopology::Direction::Anticlockwise) {
         index++;
         if (index == total_nodes_in_ring) {
             index = 0;
         }
-        return index_to_id[index];
+        return index_to_id(index);
     } else {
         index--;
         if (index < 0) {
             index = total_nodes_in_ring - 1;
         }
-        return index_to_id[index];
+        return index_to_id(index);
     }
 }
 
@@ -34,8 +34,14 @@ class RingTopology : public BasicLogicalTopology {
     int get_index_in_ring();
 
   private:
-    std::unordered_map<int, int> id_to_index;
-    std::unordered_map<int, int> index_to_id;
+    int id_to_index(int node_id);
+    int index_to_id(int index);
+
+    // Only rings built from an explicit NPU list keep these maps. Regular
+    // rings (offset > 0) are laid out arithmetically, node k being
+    // id + (k - index_in_ring) * offset, so they cost O(1) memory per rank.
+    std::unordered_map<int, int> custom_id_to_index;
+    std::unordered_map<int, int> custom_index_to_id;
 
     std::string name;
     int id;
@@ -43,10 +49,6 @@ class RingTopology : public BasicLogicalTopology {
     int total_nodes_in_ring;
     int index_in_ring;
     Dimension dimension;
-
-    virtual int get_receiver_homogeneous(int node_id,
-                                         Direction direction,
-                                         int offset);
 };
 
 }  // namespace AstraSim
@@ -0,0 +1,226 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/GraphStore.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unistd.h>
+#include <unordered_set>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "astra-sim/workload/TextWorkload.hh"
+#include "extern/graph_frontend/chakra/src/third_party/utils/protoio.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+mutex store_mutex;
+// ET contents (hash, size) -> graph and overlay loaded from them; inserted
+// before loading, so that ranks with the same ET wait for the one loading it
+map<pair<uint64_t, uint64_t>, shared_future<GraphStore::RankGraph>>
+    graphs_by_source;
+// structural hash of a whole graph -> graphs with that hash
+unordered_map<uint64_t, vector<shared_ptr<const SharedGraph>>>
+    graphs_by_structure;
+unordered_set<const SharedGraph*> accounted_graphs;
+
+bool same_structure(const SharedGraph& a, const SharedGraph& b) {
+    if (a.num_nodes() != b.num_nodes()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.num_nodes(); i++) {
+        if (a.node_hash(i) != b.node_hash(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// overlay attributes of 'graph' whose values differ from 'base'; only nodes
+// whose overlay hashes differ are decoded
+shared_ptr<const SharedGraph::Overlay> diff_overlay(const SharedGraph& base,
+                                                    const SharedGraph& graph) {
+    auto overlay = make_shared<SharedGraph::Overlay>();
+    for (uint32_t i = 0; i < graph.num_nodes(); i++) {
+        if (graph.overlay_hash(i) == base.overlay_hash(i)) {
+            continue;
+        }
+        const auto node = graph.parse_node(i);
+        const auto base_node = base.parse_node(i);
+        for (int k = 0; k < node.attr_size(); k++) {
+            const auto& attr = node.attr(k);
+            if (SharedGraph::is_overlay_attr(attr.name()) &&
+                attr.SerializeAsString() !=
+                    base_node.attr(k).SerializeAsString()) {
+                (*overlay)[node.id()].push_back(attr);
+            }
+        }
+    }
+    return overlay;
+}
+
+}  // namespace
+
+GraphStore::RankGraph GraphStore::load(const string& et_filename,
+                                       int rank,
+                                       const string& cache_dir) {
+    const auto start = chrono::steady_clock::now();
+    RankGraph rank_graph;
+    if (TextWorkload::is_text_workload(et_filename)) {
+        auto text_workload = TextWorkload::get_shared(et_filename);
+        rank_graph.graph = text_workload->graph;
+        rank_graph.overlay = text_workload->overlay(rank);
+    } else {
+        rank_graph = load_chakra_et(chakra_et_filename(et_filename, rank),
+                                    cache_dir);
+    }
+    account(rank_graph);
+
+    lock_guard<mutex> lock(store_mutex);
+    SimProfiler::workload_load_seconds +=
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return rank_graph;
+}
+
+pair<uint64_t, uint64_t> GraphStore::hash_file(const string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        LoggerFactory::get_logger("workload")
+            ->critical("workload file: {} does not exist", filename);
+        exit(EXIT_FAILURE);
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t size = 0;
+    char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        const auto read = file.gcount();
+        for (streamsize i = 0; i < read; i++) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+        size += read;
+    }
+    return {hash, size};
+}
+
+string GraphStore::chakra_et_filename(const string& et_filename, int rank) {
+    string workload_filename = et_filename + "." + to_string(rank) + ".et";
+    // Check if workload filename exists
+    if (access(workload_filename.c_str(), R_OK) < 0) {
+        string error_msg;
+        if (errno == ENOENT) {
+            error_msg =
+                "workload file: " + workload_filename + " does not exist";
+        } else if (errno == EACCES) {
+            error_msg = "workload file: " + workload_filename +
+                        " exists but is not readable";
+        } else {
+            error_msg =
+                "Unknown workload file: " + workload_filename + " access error";
+        }
+        LoggerFactory::get_logger("workload")->critical(error_msg);
+        exit(EXIT_FAILURE);
+    }
+    return workload_filename;
+}
+
+GraphStore::RankGraph GraphStore::load_chakra_et(const string& filename,
+                                                 const string& cache_dir) {
+    const auto source = hash_file(filename);
+    promise<RankGraph> loaded;
+    shared_future<RankGraph> pending;
+    {
+        // byte-identical ETs share the graph and overlay as is
+        lock_guard<mutex> lock(store_mutex);
+        auto it = graphs_by_source.find(source);
+        if (it != graphs_by_source.end()) {
+            pending = it->second;
+        } else {
+            graphs_by_source.emplace(source, loaded.get_future().share());
+        }
+    }
+    if (pending.valid()) {
+        // loaded, or being loaded by another thread
+        return pending.get();
+    }
+
+    // load outside of the lock; only the lookups are serialized
+    shared_ptr<SharedGraph> graph;
+    string cache_path;
+    if (!cache_dir.empty()) {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.cet",
+                 static_cast<unsigned long long>(source.first));
+        cache_path = cache_dir + "/" + name;
+        graph = SharedGraph::map(cache_path, source.first, source.second);
+    }
+    const bool cached = (graph != nullptr);
+    if (!cached) {
+        graph = decode_chakra_et(filename, source.first, source.second);
+        if (!cache_path.empty() && !graph->save(cache_path)) {
+            LoggerFactory::get_logger("workload")
+                ->warn("cannot write compiled workload cache {}", cache_path);
+        }
+    }
+
+    lock_guard<mutex> lock(store_mutex);
+    if (cached) {
+        ++SimProfiler::workload_ets_mapped;
+    } else {
+        ++SimProfiler::workload_ets_decoded;
+    }
+    RankGraph rank_graph = {graph, nullptr};
+    auto& candidates = graphs_by_structure[graph->graph_hash()];
+    for (const auto& stored : candidates) {
+        if (same_structure(*stored, *graph)) {
+            rank_graph = {stored, diff_overlay(*stored, *graph)};
+            break;
+        }
+    }
+    if (rank_graph.graph == graph) {
+        candidates.push_back(graph);
+    }
+    loaded.set_value(rank_graph);
+    return rank_graph;
+}
+
+shared_ptr<SharedGraph> GraphStore::decode_chakra_et(const string& filename,
+                                                     uint64_t source_hash,
+                                                     uint64_t source_size) {
+    ProtoInputStream et(filename);
+    ChakraProtoMsg::GlobalMetadata global_metadata;
+    et.read(global_metadata);
+    vector<ChakraProtoMsg::Node> nodes;
+    while (true) {
+        ChakraProtoMsg::Node node;
+        if (!et.read(node)) {
+            break;
+        }
+        nodes.push_back(move(node));
+    }
+    return SharedGraph::compile(nodes, source_hash, source_size);
+}
+
+void GraphStore::account(const RankGraph& rank_graph) {
+    lock_guard<mutex> lock(store_mutex);
+    ++SimProfiler::workload_ranks;
+    if (accounted_graphs.insert(rank_graph.graph.get()).second) {
+        ++SimProfiler::workload_graphs;
+        SimProfiler::workload_graph_nodes += rank_graph.graph->num_nodes();
+    }
+    if (rank_graph.overlay != nullptr) {
+        for (const auto& entry : *rank_graph.overlay) {
+            SimProfiler::workload_overlay_attrs += entry.second.size();
+        }
+    }
+}
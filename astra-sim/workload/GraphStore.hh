@@ -0,0 +1,61 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __GRAPH_STORE_HH__
+#define __GRAPH_STORE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "astra-sim/workload/SharedGraph.hh"
+
+namespace AstraSim {
+
+// Process-wide store of workload graphs. Per-rank ETs are loaded once and
+// deduplicated by content: ranks whose graphs differ only in overlay
+// attributes (SharedGraph::is_overlay_attr) share one immutable graph and
+// keep the differing attributes in a small per-rank overlay. Memory thus
+// scales with the number of distinct graphs rather than with the number of
+// ranks.
+//
+// Given a cache directory, each decoded ET is also saved there in compiled
+// form under the hash of its contents, and later runs map the compiled
+// graph instead of decoding the protobuf ET again. A changed ET hashes
+// differently, so stale entries are never used.
+class GraphStore {
+  public:
+    struct RankGraph {
+        std::shared_ptr<const SharedGraph> graph;
+        std::shared_ptr<const SharedGraph::Overlay> overlay;
+    };
+
+    // Graph of 'rank' for the workload configuration 'et_filename', either
+    // a text workload or the prefix of per-rank Chakra ETs. 'cache_dir' may
+    // be empty to compile in memory only.
+    static RankGraph load(const std::string& et_filename,
+                          int rank,
+                          const std::string& cache_dir);
+
+    // FNV-1a hash and size of the contents of a file
+    static std::pair<uint64_t, uint64_t> hash_file(const std::string& filename);
+    // Chakra ET of 'rank'; exits if it cannot be read
+    static std::string chakra_et_filename(const std::string& et_filename,
+                                          int rank);
+
+  private:
+    static RankGraph load_chakra_et(const std::string& filename,
+                                    const std::string& cache_dir);
+    static std::shared_ptr<SharedGraph> decode_chakra_et(
+        const std::string& filename,
+        uint64_t source_hash,
+        uint64_t source_size);
+    static void account(const RankGraph& rank_graph);
+};
+
+}  // namespace AstraSim
+
+#endif /* __GRAPH_STORE_HH__ */
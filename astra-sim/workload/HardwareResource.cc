@@ -7,13 +7,21 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/workload/HardwareResource.hh"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+#include "astra-sim/system/SimClock.hh"
+
 using namespace std;
 using namespace AstraSim;
 using namespace Chakra;
 
 typedef ChakraProtoMsg::NodeType ChakraNodeType;
 
-HardwareResource::HardwareResource(uint32_t num_npus)
+HardwareResource::HardwareResource(uint32_t num_npus,
+                                   uint32_t num_comp_streams,
+                                   uint32_t num_comm_streams)
     : num_npus(num_npus),
       num_in_flight_cpu_ops(0),
       num_in_flight_gpu_comm_ops(0),
@@ -27,81 +35,175 @@ HardwareResource::HardwareResource(uint32_t num_npus)
     tics_gpu_ops = 0;
     tics_gpu_comms = 0;
 
-    cpu_ops_node = NULL;
-    gpu_ops_node = NULL;
-    gpu_comms_node = NULL;
+    streams[CPU].resize(1);
+    streams[GPUComp].resize(max(num_comp_streams, 1u));
+    streams[GPUComm].resize(max(num_comm_streams, 1u));
+    gpu_comp_busy_since = 0;
+    gpu_comp_busy_ticks = 0;
 }
 
 void HardwareResource::occupy(const shared_ptr<Chakra::ETFeederNode> node) {
-    if (node->is_cpu_op()) {
-        assert(num_in_flight_cpu_ops == 0);
+    const auto resource = resource_of(node);
+    if (resource == Recv) {
+        return;
+    }
+    const int pinned = pinned_stream(node, resource);
+    auto& resource_streams = streams[resource];
+    uint32_t s = 0;
+    if (pinned >= 0) {
+        s = static_cast<uint32_t>(pinned);
+    } else {
+        while (s < resource_streams.size() &&
+               resource_streams[s].node != nullptr) {
+            s++;
+        }
+    }
+    assert(s < resource_streams.size() && resource_streams[s].node == nullptr);
+    auto& stream = resource_streams[s];
+    stream.node = node;
+    stream.busy_since = SimClock::now();
+    ++stream.num_ops;
+
+    if (resource == CPU) {
         ++num_in_flight_cpu_ops;
         ++num_cpu_ops;
-    } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            assert(num_in_flight_gpu_comp_ops == 0);
-            ++num_in_flight_gpu_comp_ops;
-            ++num_gpu_ops;
-            gpu_ops_node = node;
-        } else {
-            if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                return;
-            }
-            assert(num_in_flight_gpu_comm_ops == 0);
-            ++num_in_flight_gpu_comm_ops;
-            ++num_gpu_comms;
-            gpu_comms_node = node;
+    } else if (resource == GPUComp) {
+        if (num_in_flight_gpu_comp_ops++ == 0) {
+            gpu_comp_busy_since = stream.busy_since;
         }
+        ++num_gpu_ops;
+    } else {
+        ++num_in_flight_gpu_comm_ops;
+        ++num_gpu_comms;
     }
 }
 
 void HardwareResource::release(const shared_ptr<Chakra::ETFeederNode> node) {
-    if (node->is_cpu_op()) {
+    const auto resource = resource_of(node);
+    if (resource == Recv) {
+        return;
+    }
+    auto stream = streams[resource].begin();
+    while (stream != streams[resource].end() && stream->node != node) {
+        ++stream;
+    }
+    assert(stream != streams[resource].end());
+    const Tick now = SimClock::now();
+    stream->node = nullptr;
+    stream->busy_ticks += now - stream->busy_since;
+
+    if (resource == CPU) {
         --num_in_flight_cpu_ops;
-        assert(num_in_flight_cpu_ops == 0);
-    } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            --num_in_flight_gpu_comp_ops;
-            assert(num_in_flight_gpu_comp_ops == 0);
-        } else {
-            if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                return;
-            }
-            --num_in_flight_gpu_comm_ops;
-            assert(num_in_flight_gpu_comm_ops == 0);
+    } else if (resource == GPUComp) {
+        if (--num_in_flight_gpu_comp_ops == 0) {
+            gpu_comp_busy_ticks += now - gpu_comp_busy_since;
         }
+    } else {
+        --num_in_flight_gpu_comm_ops;
     }
 }
 
+HardwareResource::Resource HardwareResource::resource_of(
+    const shared_ptr<Chakra::ETFeederNode>& node) {
+    if (node->is_cpu_op()) {
+        return CPU;
+    }
+    if (node->type() == ChakraNodeType::COMP_NODE) {
+        return GPUComp;
+    }
+    if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
+        return Recv;
+    }
+    return GPUComm;
+}
+
 bool HardwareResource::is_available(
     const shared_ptr<Chakra::ETFeederNode> node) const {
-    if (node->is_cpu_op()) {
-        if (num_in_flight_cpu_ops == 0) {
+    const auto resource = resource_of(node);
+    if (resource == Recv) {
+        return true;
+    }
+    const int pinned = pinned_stream(node, resource);
+    if (pinned >= 0) {
+        return streams[resource][pinned].node == nullptr;
+    }
+    for (const auto& stream : streams[resource]) {
+        if (stream.node == nullptr) {
             return true;
-        } else {
-            return false;
         }
+    }
+    return false;
+}
+
+int HardwareResource::pinned_stream(
+    const shared_ptr<Chakra::ETFeederNode>& node, Resource resource) const {
+    if (streams[resource].size() <= 1 || !node->has_other_attr("stream")) {
+        return -1;
+    }
+    const auto& attr = node->get_other_attr("stream");
+    uint64_t stream_id;
+    if (attr.has_int32_val() && attr.int32_val() >= 0) {
+        stream_id = attr.int32_val();
+    } else if (attr.has_int64_val() && attr.int64_val() >= 0) {
+        stream_id = attr.int64_val();
+    } else if (attr.has_uint64_val()) {
+        stream_id = attr.uint64_val();
     } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            if (num_in_flight_gpu_comp_ops == 0) {
-                return true;
-            } else {
-                return false;
-            }
-        } else {
-            if (num_in_flight_gpu_comm_ops == 0) {
-                return true;
-            } else {
-                if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                    return true;
-                }
-                if (num_in_flight_gpu_comm_ops == 0) {
-                    return true;
-                }
-                return false;
+        return -1;
+    }
+    return static_cast<int>(stream_id % streams[resource].size());
+}
+
+uint32_t HardwareResource::num_ready_queues() const {
+    uint32_t num_queues = NUM_RESOURCES;
+    for (int r = 0; r < NUM_RESOURCES; r++) {
+        num_queues += static_cast<uint32_t>(streams[r].size());
+    }
+    return num_queues;
+}
+
+uint32_t HardwareResource::ready_queue_of(
+    const shared_ptr<Chakra::ETFeederNode>& node) const {
+    const auto resource = resource_of(node);
+    const int pinned = resource == Recv ? -1 : pinned_stream(node, resource);
+    if (pinned < 0) {
+        return resource;
+    }
+    // queues of the streams follow the per-resource ones
+    uint32_t queue = NUM_RESOURCES;
+    for (int r = 0; r < resource; r++) {
+        queue += static_cast<uint32_t>(streams[r].size());
+    }
+    return queue + pinned;
+}
+
+Tick HardwareResource::gpu_comp_ticks() const {
+    // with a single stream the replayed runtimes are exact
+    if (streams[GPUComp].size() == 1) {
+        return tics_gpu_ops;
+    }
+    return gpu_comp_busy_ticks;
+}
+
+string HardwareResource::stream_occupancy(Tick elapsed) const {
+    string occupancy;
+    const pair<Resource, const char*> resources[] = {
+        {GPUComp, "compute"}, {GPUComm, "communication"}};
+    for (const auto& resource : resources) {
+        occupancy += occupancy.empty() ? "" : ", ";
+        occupancy += resource.second;
+        for (const auto& stream : streams[resource.first]) {
+            Tick busy_ticks = stream.busy_ticks;
+            if (stream.node != nullptr) {
+                busy_ticks += SimClock::now() - stream.busy_since;
             }
+            char percent[16];
+            snprintf(percent, sizeof(percent), " %.1f%%",
+                     elapsed > 0 ? 100.0 * busy_ticks / elapsed : 0.0);
+            occupancy += percent;
         }
     }
+    return occupancy;
 }
 
 void HardwareResource::report() {
@@ -9,22 +9,48 @@ LICENSE file in the root directory of this source tree.
 #define __HARDWARE_RESOURCE_HH__
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
+#include "astra-sim/system/Common.hh"
 #include "extern/graph_frontend/chakra/src/feeder/et_feeder.h"
 
 namespace AstraSim {
 
+// Compute and communication engines of an NPU. The GPU runs a configurable
+// number of compute and communication streams, each running one node at a
+// time; the CPU runs one node at a time, and receives are never limited.
+// A node runs on the stream its ET "stream" attribute pins it to (modulo
+// the number of streams), or else on any free stream.
 class HardwareResource {
   public:
-    HardwareResource(uint32_t num_npus);
+    // Resource a node waits for. Receives never wait, and every other
+    // non-CPU, non-compute node waits for the communication engine.
+    enum Resource { CPU = 0, GPUComp, GPUComm, Recv, NUM_RESOURCES };
+
+    HardwareResource(uint32_t num_npus,
+                     uint32_t num_comp_streams = 1,
+                     uint32_t num_comm_streams = 1);
+    static Resource resource_of(
+        const std::shared_ptr<Chakra::ETFeederNode>& node);
     void occupy(const std::shared_ptr<Chakra::ETFeederNode> node);
     void release(const std::shared_ptr<Chakra::ETFeederNode> node);
     bool is_available(const std::shared_ptr<Chakra::ETFeederNode> node) const;
     void report();
 
-    std::shared_ptr<Chakra::ETFeederNode> cpu_ops_node;
-    std::shared_ptr<Chakra::ETFeederNode> gpu_ops_node;
-    std::shared_ptr<Chakra::ETFeederNode> gpu_comms_node;
+    uint32_t num_streams(Resource resource) const {
+        return static_cast<uint32_t>(streams[resource].size());
+    }
+    // Dependency-free nodes wait in one queue per resource, or per stream
+    // for the nodes pinned to one, so that a queue only waits for its head.
+    uint32_t num_ready_queues() const;
+    uint32_t ready_queue_of(
+        const std::shared_ptr<Chakra::ETFeederNode>& node) const;
+    // time the GPU computed on any stream
+    Tick gpu_comp_ticks() const;
+    // busy time of every compute and communication stream, e.g.
+    // "compute 45.0% 30.1%, communication 80.2% 12.5%"
+    std::string stream_occupancy(Tick elapsed) const;
 
     const uint32_t num_npus;
     uint32_t num_in_flight_cpu_ops;
@@ -38,6 +64,23 @@ class HardwareResource {
     uint64_t tics_cpu_ops;
     uint64_t tics_gpu_ops;
     uint64_t tics_gpu_comms;
+
+  private:
+    struct Stream {
+        std::shared_ptr<Chakra::ETFeederNode> node;
+        Tick busy_since = 0;
+        Tick busy_ticks = 0;
+        uint64_t num_ops = 0;
+    };
+
+    // stream of 'resource' the ET pins 'node' to, -1 if any
+    int pinned_stream(const std::shared_ptr<Chakra::ETFeederNode>& node,
+                      Resource resource) const;
+
+    std::vector<Stream> streams[NUM_RESOURCES];
+    // union of the busy time of the compute streams
+    Tick gpu_comp_busy_since;
+    Tick gpu_comp_busy_ticks;
 };
 
 }  // namespace AstraSim
@@ -0,0 +1,431 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/SharedGraph.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "astra-sim/common/Logging.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+constexpr char compiled_magic[8] = {'A', 'S', 'T', 'R', 'A', 'E', 'T', 'C'};
+constexpr uint64_t compiled_version = 1;
+
+uint64_t fnv1a(const string& bytes,
+               uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+// byte offsets of the sections of a compiled graph, each 8-byte aligned
+struct Layout {
+    uint64_t ids;
+    uint64_t id_order;
+    uint64_t node_hashes;
+    uint64_t overlay_hashes;
+    uint64_t parent_counts;
+    uint64_t child_offsets;
+    uint64_t child_indices;
+    uint64_t blob_offsets;
+    uint64_t blob;
+    uint64_t total;
+};
+
+Layout layout_of(uint64_t header_size,
+                 uint64_t num_nodes,
+                 uint64_t num_edges,
+                 uint64_t blob_size) {
+    Layout layout;
+    uint64_t at = align8(header_size);
+    layout.ids = at;
+    at = align8(at + num_nodes * sizeof(uint64_t));
+    layout.id_order = at;
+    at = align8(at + num_nodes * sizeof(uint32_t));
+    layout.node_hashes = at;
+    at = align8(at + num_nodes * sizeof(uint64_t));
+    layout.overlay_hashes = at;
+    at = align8(at + num_nodes * sizeof(uint64_t));
+    layout.parent_counts = at;
+    at = align8(at + num_nodes * sizeof(uint32_t));
+    layout.child_offsets = at;
+    at = align8(at + (num_nodes + 1) * sizeof(uint64_t));
+    layout.child_indices = at;
+    at = align8(at + num_edges * sizeof(uint32_t));
+    layout.blob_offsets = at;
+    at = align8(at + (num_nodes + 1) * sizeof(uint64_t));
+    layout.blob = at;
+    layout.total = at + blob_size;
+    return layout;
+}
+
+template <typename T>
+void copy_section(vector<char>& buffer, uint64_t offset, const vector<T>& v) {
+    if (!v.empty()) {
+        memcpy(buffer.data() + offset, v.data(), v.size() * sizeof(T));
+    }
+}
+
+}  // namespace
+
+bool SharedGraph::is_overlay_attr(const string& name) {
+    return name == "comm_src" || name == "comm_dst" || name == "comm_tag" ||
+           name == "alltoall_send_matrix" || name == "alltoall_recv_matrix";
+}
+
+shared_ptr<SharedGraph> SharedGraph::compile(
+    const vector<ChakraProtoMsg::Node>& nodes,
+    uint64_t source_hash,
+    uint64_t source_size) {
+    const uint64_t num_nodes = nodes.size();
+
+    vector<uint64_t> ids(num_nodes);
+    vector<uint64_t> node_hashes(num_nodes);
+    vector<uint64_t> overlay_hashes(num_nodes);
+    vector<uint64_t> blob_offsets(num_nodes + 1, 0);
+    string blob;
+    unordered_map<uint64_t, uint32_t> index_of;
+    index_of.reserve(num_nodes);
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        const auto& node = nodes[i];
+        ids[i] = node.id();
+        index_of[node.id()] = i;
+
+        ChakraProtoMsg::Node structure(node);
+        string overlay_bytes;
+        for (auto& attr : *structure.mutable_attr()) {
+            if (is_overlay_attr(attr.name())) {
+                overlay_bytes += attr.SerializeAsString();
+                attr.clear_value();
+            }
+        }
+        node_hashes[i] = fnv1a(structure.SerializeAsString());
+        overlay_hashes[i] = fnv1a(overlay_bytes);
+
+        blob += node.SerializeAsString();
+        blob_offsets[i + 1] = blob.size();
+    }
+
+    // CSR of the children of each node
+    vector<uint32_t> parent_counts(num_nodes, 0);
+    vector<uint64_t> child_offsets(num_nodes + 1, 0);
+    uint64_t dangling_deps = 0;
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        for (auto parent_id : nodes[i].data_deps()) {
+            auto it = index_of.find(parent_id);
+            if (it == index_of.end()) {
+                ++dangling_deps;
+                continue;
+            }
+            ++child_offsets[it->second + 1];
+            ++parent_counts[i];
+        }
+    }
+    partial_sum(child_offsets.begin(), child_offsets.end(),
+                child_offsets.begin());
+    vector<uint32_t> child_indices(child_offsets.back());
+    vector<uint64_t> next_child(child_offsets.begin(), child_offsets.end() - 1);
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        for (auto parent_id : nodes[i].data_deps()) {
+            auto it = index_of.find(parent_id);
+            if (it != index_of.end()) {
+                child_indices[next_child[it->second]++] = i;
+            }
+        }
+    }
+    if (dangling_deps > 0) {
+        LoggerFactory::get_logger("workload")
+            ->warn("{} dependencies on nodes missing from the graph are "
+                   "ignored",
+                   dangling_deps);
+    }
+
+    vector<uint32_t> id_order(num_nodes);
+    iota(id_order.begin(), id_order.end(), 0);
+    sort(id_order.begin(), id_order.end(),
+         [&ids](uint32_t a, uint32_t b) { return ids[a] < ids[b]; });
+    bool dense_ids = true;
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        dense_ids = dense_ids && (ids[i] == ids[0] + i);
+    }
+
+    const auto layout = layout_of(sizeof(Header), num_nodes,
+                                  child_indices.size(), blob.size());
+    auto graph = shared_ptr<SharedGraph>(new SharedGraph());
+    auto& buffer = graph->owned_buffer;
+    buffer.assign(layout.total, 0);
+
+    Header header;
+    memcpy(header.magic, compiled_magic, sizeof(header.magic));
+    header.version = compiled_version;
+    header.source_hash = source_hash;
+    header.source_size = source_size;
+    header.num_nodes = num_nodes;
+    header.num_edges = child_indices.size();
+    header.blob_size = blob.size();
+    header.dense_ids = dense_ids ? 1 : 0;
+    memcpy(buffer.data(), &header, sizeof(header));
+    copy_section(buffer, layout.ids, ids);
+    copy_section(buffer, layout.id_order, id_order);
+    copy_section(buffer, layout.node_hashes, node_hashes);
+    copy_section(buffer, layout.overlay_hashes, overlay_hashes);
+    copy_section(buffer, layout.parent_counts, parent_counts);
+    copy_section(buffer, layout.child_offsets, child_offsets);
+    copy_section(buffer, layout.child_indices, child_indices);
+    copy_section(buffer, layout.blob_offsets, blob_offsets);
+    memcpy(buffer.data() + layout.blob, blob.data(), blob.size());
+
+    graph->bind(buffer.data(), buffer.size());
+    return graph;
+}
+
+shared_ptr<SharedGraph> SharedGraph::map(const string& path,
+                                         uint64_t source_hash,
+                                         uint64_t source_size) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto graph = shared_ptr<SharedGraph>(new SharedGraph());
+    graph->mapped_buffer = addr;
+    graph->buffer_size = st.st_size;
+    if (!graph->bind(static_cast<const char*>(addr), st.st_size) ||
+        graph->header->source_hash != source_hash ||
+        graph->header->source_size != source_size) {
+        return nullptr;
+    }
+    return graph;
+}
+
+SharedGraph::~SharedGraph() {
+    if (mapped_buffer != nullptr) {
+        munmap(mapped_buffer, buffer_size);
+    }
+}
+
+bool SharedGraph::bind(const char* base, uint64_t size) {
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    auto candidate = reinterpret_cast<const Header*>(base);
+    if (memcmp(candidate->magic, compiled_magic, sizeof(compiled_magic)) !=
+            0 ||
+        candidate->version != compiled_version) {
+        return false;
+    }
+    const auto layout =
+        layout_of(sizeof(Header), candidate->num_nodes, candidate->num_edges,
+                  candidate->blob_size);
+    if (layout.total != size) {
+        return false;
+    }
+
+    header = candidate;
+    buffer_size = size;
+    ids = reinterpret_cast<const uint64_t*>(base + layout.ids);
+    id_order = reinterpret_cast<const uint32_t*>(base + layout.id_order);
+    node_hashes = reinterpret_cast<const uint64_t*>(base + layout.node_hashes);
+    overlay_hashes =
+        reinterpret_cast<const uint64_t*>(base + layout.overlay_hashes);
+    parent_counts =
+        reinterpret_cast<const uint32_t*>(base + layout.parent_counts);
+    child_offsets =
+        reinterpret_cast<const uint64_t*>(base + layout.child_offsets);
+    child_indices =
+        reinterpret_cast<const uint32_t*>(base + layout.child_indices);
+    blob_offsets =
+        reinterpret_cast<const uint64_t*>(base + layout.blob_offsets);
+    blob = base + layout.blob;
+    return child_offsets[header->num_nodes] == header->num_edges &&
+           blob_offsets[header->num_nodes] == header->blob_size;
+}
+
+bool SharedGraph::save(const string& path) const {
+    // write aside and rename, so that concurrent runs never map a partial
+    // file; mkstemp names the file uniquely per writer
+    string tmp_path = path + ".tmp.XXXXXX";
+    const int fd = mkstemp(&tmp_path[0]);
+    if (fd < 0) {
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(header);
+    uint64_t written = 0;
+    while (written < buffer_size) {
+        const auto n = write(fd, data + written, buffer_size - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            close(fd);
+            remove(tmp_path.c_str());
+            return false;
+        }
+        written += n;
+    }
+    // mkstemp creates the file private to its owner
+    fchmod(fd, 0644);
+    if (close(fd) != 0) {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t SharedGraph::graph_hash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < num_nodes(); i++) {
+        hash ^= node_hashes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint32_t SharedGraph::index_of(uint64_t node_id) const {
+    const uint32_t n = num_nodes();
+    if (header->dense_ids) {
+        if (n > 0 && node_id >= ids[0] && node_id - ids[0] < n) {
+            return static_cast<uint32_t>(node_id - ids[0]);
+        }
+    } else {
+        auto it = lower_bound(
+            id_order, id_order + n, node_id,
+            [this](uint32_t index, uint64_t id) { return ids[index] < id; });
+        if (it != id_order + n && ids[*it] == node_id) {
+            return *it;
+        }
+    }
+    LoggerFactory::get_logger("workload")
+        ->critical("node {} is not part of the workload graph", node_id);
+    exit(EXIT_FAILURE);
+}
+
+ChakraProtoMsg::Node SharedGraph::parse_node(uint32_t index) const {
+    ChakraProtoMsg::Node node;
+    node.ParseFromArray(blob + blob_offsets[index],
+                        static_cast<int>(blob_offsets[index + 1] -
+                                         blob_offsets[index]));
+    return node;
+}
+
+shared_ptr<Chakra::ETFeederNode> SharedGraph::make_node(
+    uint32_t index, const Overlay* overlay) const {
+    auto node = make_shared<ChakraProtoMsg::Node>(parse_node(index));
+    if (overlay != nullptr) {
+        auto it = overlay->find(node->id());
+        if (it != overlay->end()) {
+            for (const auto& rank_attr : it->second) {
+                bool replaced = false;
+                for (auto& attr : *node->mutable_attr()) {
+                    if (attr.name() == rank_attr.name()) {
+                        attr = rank_attr;
+                        replaced = true;
+                        break;
+                    }
+                }
+                if (!replaced) {
+                    *node->add_attr() = rank_attr;
+                }
+            }
+        }
+    }
+    return make_shared<Chakra::ETFeederNode>(node);
+}
+
+SharedGraphFeeder::SharedGraphFeeder(
+    shared_ptr<const SharedGraph> graph,
+    shared_ptr<const SharedGraph::Overlay> overlay)
+    : graph(move(graph)), overlay(move(overlay)) {
+    const auto num_nodes = this->graph->num_nodes();
+    this->unresolved_parents.resize(num_nodes);
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        this->unresolved_parents[i] = this->graph->num_parents(i);
+        if (this->unresolved_parents[i] == 0) {
+            this->issuable_nodes.push(this->graph->node_id(i));
+        }
+    }
+    this->num_remaining_nodes = num_nodes;
+}
+
+bool SharedGraphFeeder::hasNodesToIssue() {
+    return num_remaining_nodes > 0;
+}
+
+shared_ptr<Chakra::ETFeederNode> SharedGraphFeeder::getNextIssuableNode() {
+    if (issuable_nodes.empty()) {
+        return nullptr;
+    }
+    const auto node_id = issuable_nodes.top();
+    issuable_nodes.pop();
+    auto& node = live_nodes[node_id];
+    if (node == nullptr) {
+        node = graph->make_node(graph->index_of(node_id), overlay.get());
+    }
+    return node;
+}
+
+void SharedGraphFeeder::pushBackIssuableNode(uint64_t node_id) {
+    issuable_nodes.push(node_id);
+}
+
+shared_ptr<Chakra::ETFeederNode> SharedGraphFeeder::lookupNode(
+    uint64_t node_id) {
+    auto it = live_nodes.find(node_id);
+    if (it == live_nodes.end()) {
+        LoggerFactory::get_logger("workload")
+            ->critical("node {} looked up before being issued", node_id);
+        exit(EXIT_FAILURE);
+    }
+    return it->second;
+}
+
+void SharedGraphFeeder::freeChildrenNodes(uint64_t node_id) {
+    const auto index = graph->index_of(node_id);
+    for (auto child = graph->children_begin(index);
+         child != graph->children_end(index); ++child) {
+        if (--unresolved_parents[*child] == 0) {
+            issuable_nodes.push(graph->node_id(*child));
+        }
+    }
+}
+
+void SharedGraphFeeder::removeNode(uint64_t node_id) {
+    if (live_nodes.erase(node_id) > 0) {
+        --num_remaining_nodes;
+    }
+}
@@ -0,0 +1,156 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __SHARED_GRAPH_HH__
+#define __SHARED_GRAPH_HH__
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/workload/WorkloadFeeder.hh"
+
+namespace AstraSim {
+
+// Dependency graph of a workload. It is immutable once compiled and shared
+// by every rank running the same graph; attributes that differ across those
+// ranks live in a per-rank Overlay, and issue state in a SharedGraphFeeder.
+//
+// The graph is stored in one flat buffer with the same layout in memory
+// and on disk, so that a compiled graph can be saved once and mapped back
+// without decoding: the per-node fields the walk needs as arrays, the
+// dependency edges as CSR offset/index arrays, and the serialized Chakra
+// nodes in a side table that is only parsed when a node is issued.
+class SharedGraph {
+  public:
+    // node id -> attributes of one rank replacing those of the shared node
+    using Overlay = std::unordered_map<
+        uint64_t,
+        std::vector<ChakraProtoMsg::AttributeProto>>;
+
+    // Attributes that may differ between ranks sharing a graph.
+    static bool is_overlay_attr(const std::string& name);
+
+    // Compile 'nodes', whose data_deps refer to node ids, into a graph.
+    // 'source_hash' and 'source_size' identify the file they come from.
+    static std::shared_ptr<SharedGraph> compile(
+        const std::vector<ChakraProtoMsg::Node>& nodes,
+        uint64_t source_hash = 0,
+        uint64_t source_size = 0);
+    // Map a graph saved by save(). Returns nullptr if the file is missing,
+    // malformed, or compiled from a different source.
+    static std::shared_ptr<SharedGraph> map(const std::string& path,
+                                            uint64_t source_hash,
+                                            uint64_t source_size);
+
+    SharedGraph(const SharedGraph&) = delete;
+    SharedGraph& operator=(const SharedGraph&) = delete;
+    ~SharedGraph();
+
+    // Atomically write the compiled graph to 'path'.
+    bool save(const std::string& path) const;
+
+    uint32_t num_nodes() const {
+        return static_cast<uint32_t>(header->num_nodes);
+    }
+    uint64_t node_id(uint32_t index) const {
+        return ids[index];
+    }
+    uint32_t num_parents(uint32_t index) const {
+        return parent_counts[index];
+    }
+    const uint32_t* children_begin(uint32_t index) const {
+        return child_indices + child_offsets[index];
+    }
+    const uint32_t* children_end(uint32_t index) const {
+        return child_indices + child_offsets[index + 1];
+    }
+    // hash of a node with the values of its overlay attributes cleared
+    uint64_t node_hash(uint32_t index) const {
+        return node_hashes[index];
+    }
+    // hash of the values of the overlay attributes of a node
+    uint64_t overlay_hash(uint32_t index) const {
+        return overlay_hashes[index];
+    }
+    // structural hash of the whole graph
+    uint64_t graph_hash() const;
+    uint32_t index_of(uint64_t node_id) const;
+
+    ChakraProtoMsg::Node parse_node(uint32_t index) const;
+    // Instantiate the node at 'index' with the attributes of 'overlay'.
+    std::shared_ptr<Chakra::ETFeederNode> make_node(
+        uint32_t index,
+        const Overlay* overlay) const;
+
+  private:
+    struct Header {
+        char magic[8];
+        uint64_t version;
+        uint64_t source_hash;
+        uint64_t source_size;
+        uint64_t num_nodes;
+        uint64_t num_edges;
+        uint64_t blob_size;
+        // ids[i] == ids[0] + i
+        uint64_t dense_ids;
+    };
+
+    SharedGraph() = default;
+    // Point the arrays into 'size' bytes at 'base'; false if malformed.
+    bool bind(const char* base, uint64_t size);
+
+    // either owned or mapped
+    std::vector<char> owned_buffer;
+    void* mapped_buffer = nullptr;
+    uint64_t buffer_size = 0;
+
+    const Header* header = nullptr;
+    const uint64_t* ids = nullptr;
+    // node indices in ascending id order
+    const uint32_t* id_order = nullptr;
+    const uint64_t* node_hashes = nullptr;
+    const uint64_t* overlay_hashes = nullptr;
+    const uint32_t* parent_counts = nullptr;
+    const uint64_t* child_offsets = nullptr;
+    const uint32_t* child_indices = nullptr;
+    const uint64_t* blob_offsets = nullptr;
+    const char* blob = nullptr;
+};
+
+// Issue state of one rank walking a SharedGraph.
+class SharedGraphFeeder : public WorkloadFeeder {
+  public:
+    SharedGraphFeeder(std::shared_ptr<const SharedGraph> graph,
+                      std::shared_ptr<const SharedGraph::Overlay> overlay);
+
+    bool hasNodesToIssue() override;
+    std::shared_ptr<Chakra::ETFeederNode> getNextIssuableNode() override;
+    void pushBackIssuableNode(uint64_t node_id) override;
+    std::shared_ptr<Chakra::ETFeederNode> lookupNode(
+        uint64_t node_id) override;
+    void freeChildrenNodes(uint64_t node_id) override;
+    void removeNode(uint64_t node_id) override;
+
+  private:
+    std::shared_ptr<const SharedGraph> graph;
+    std::shared_ptr<const SharedGraph::Overlay> overlay;
+    std::vector<uint32_t> unresolved_parents;
+    // issued in ascending id order, as Chakra::ETFeeder does
+    std::priority_queue<uint64_t,
+                        std::vector<uint64_t>,
+                        std::greater<uint64_t>>
+        issuable_nodes;
+    std::unordered_map<uint64_t, std::shared_ptr<Chakra::ETFeederNode>>
+        live_nodes;
+    uint64_t num_remaining_nodes;
+};
+
+}  // namespace AstraSim
+
+#endif /* __SHARED_GRAPH_HH__ */
@@ -0,0 +1,230 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/StreamingETFeeder.hh"
+
+#include <algorithm>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "extern/graph_frontend/chakra/src/third_party/utils/protoio.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+StreamingETFeeder::StreamingETFeeder(const string& filename,
+                                     uint64_t window_size)
+    : filename(filename), window_size(max<uint64_t>(window_size, 1)) {
+    // the ET is opened on first use, so that ranks constructed in parallel
+    // do not hold a window each before the simulation starts
+    this->et_complete = false;
+    this->num_issued_nodes = 0;
+    this->num_issued_local_nodes = 0;
+    this->num_blocked_nodes = 0;
+}
+
+namespace {
+
+// nodes whose completion may depend on other ranks
+bool is_comm(const shared_ptr<Chakra::ETFeederNode>& node) {
+    const auto type = node->type();
+    return type == ChakraProtoMsg::COMM_SEND_NODE ||
+           type == ChakraProtoMsg::COMM_RECV_NODE ||
+           type == ChakraProtoMsg::COMM_COLL_NODE;
+}
+
+}  // namespace
+
+StreamingETFeeder::~StreamingETFeeder() = default;
+
+bool StreamingETFeeder::hasNodesToIssue() {
+    fill_window();
+    return !window.empty();
+}
+
+shared_ptr<Chakra::ETFeederNode> StreamingETFeeder::getNextIssuableNode() {
+    fill_window();
+    if (issuable_nodes.empty()) {
+        return nullptr;
+    }
+    const auto node_id = issuable_nodes.top();
+    issuable_nodes.pop();
+    ++num_issued_nodes;
+    auto& entry = window.at(node_id);
+    if (is_comm(entry.node)) {
+        entry.in_flight_comm = true;
+        for (auto child_id : entry.children) {
+            remove_local_blocker(window.at(child_id));
+        }
+    } else {
+        ++num_issued_local_nodes;
+    }
+    return entry.node;
+}
+
+void StreamingETFeeder::pushBackIssuableNode(uint64_t node_id) {
+    --num_issued_nodes;
+    auto& entry = window.at(node_id);
+    if (entry.in_flight_comm) {
+        entry.in_flight_comm = false;
+        for (auto child_id : entry.children) {
+            add_local_blocker(window.at(child_id));
+        }
+    } else {
+        --num_issued_local_nodes;
+    }
+    issuable_nodes.push(node_id);
+}
+
+shared_ptr<Chakra::ETFeederNode> StreamingETFeeder::lookupNode(
+    uint64_t node_id) {
+    auto it = window.find(node_id);
+    if (it == window.end()) {
+        LoggerFactory::get_logger("workload")
+            ->critical("node {} looked up outside of the ET window", node_id);
+        exit(EXIT_FAILURE);
+    }
+    return it->second.node;
+}
+
+void StreamingETFeeder::freeChildrenNodes(uint64_t node_id) {
+    if (node_id >= resolved.size()) {
+        resolved.resize(max<uint64_t>(node_id + 1, resolved.size() * 2));
+    }
+    resolved[node_id] = true;
+    auto it = window.find(node_id);
+    if (it == window.end()) {
+        return;
+    }
+    for (auto child_id : it->second.children) {
+        auto& child = window.at(child_id);
+        if (!it->second.in_flight_comm) {
+            remove_local_blocker(child);
+        }
+        resolve_parent(child);
+    }
+    it->second.children.clear();
+    it->second.children.shrink_to_fit();
+}
+
+void StreamingETFeeder::removeNode(uint64_t node_id) {
+    auto it = window.find(node_id);
+    if (it != window.end()) {
+        if (!it->second.in_flight_comm) {
+            --num_issued_local_nodes;
+        }
+        window.erase(it);
+        --num_issued_nodes;
+    }
+    fill_window();
+}
+
+void StreamingETFeeder::fill_window() {
+    if (et == nullptr && !et_complete) {
+        et = make_unique<ProtoInputStream>(filename);
+        ChakraProtoMsg::GlobalMetadata global_metadata;
+        et->read(global_metadata);
+        ++SimProfiler::workload_streamed_ranks;
+    }
+    while (!et_complete &&
+           (window.size() < window_size || window_stalled())) {
+        ChakraProtoMsg::Node proto_node;
+        if (!et->read(proto_node)) {
+            et_complete = true;
+            et.reset();
+            drop_missing_parents();
+            break;
+        }
+        read_node(move(proto_node));
+    }
+    SimProfiler::workload_window_peak =
+        max<uint64_t>(SimProfiler::workload_window_peak, window.size());
+}
+
+bool StreamingETFeeder::window_stalled() const {
+    if (!issuable_nodes.empty() || num_issued_local_nodes > 0) {
+        return false;
+    }
+    // with nothing issued, even nodes waiting for other nodes in the window
+    // wait for the rest of the file
+    return num_issued_nodes == 0 || num_blocked_nodes == 0;
+}
+
+void StreamingETFeeder::read_node(ChakraProtoMsg::Node&& proto_node) {
+    const auto node_id = proto_node.id();
+    auto& entry = window[node_id];
+    entry.unresolved_parents = 0;
+    entry.local_blockers = 0;
+    entry.in_flight_comm = false;
+    for (auto parent_id : proto_node.data_deps()) {
+        if (is_resolved(parent_id)) {
+            continue;
+        }
+        auto parent = window.find(parent_id);
+        if (parent != window.end()) {
+            parent->second.children.push_back(node_id);
+            if (!parent->second.in_flight_comm) {
+                ++entry.local_blockers;
+            }
+        } else {
+            waiting_children[parent_id].push_back(node_id);
+        }
+        ++entry.unresolved_parents;
+    }
+    entry.node = make_shared<Chakra::ETFeederNode>(
+        make_shared<ChakraProtoMsg::Node>(move(proto_node)));
+
+    if (entry.local_blockers > 0) {
+        ++num_blocked_nodes;
+    }
+
+    // children read before this node
+    auto waiting = waiting_children.find(node_id);
+    if (waiting != waiting_children.end()) {
+        entry.children = move(waiting->second);
+        waiting_children.erase(waiting);
+        for (auto child_id : entry.children) {
+            add_local_blocker(window.at(child_id));
+        }
+    }
+    if (entry.unresolved_parents == 0) {
+        issuable_nodes.push(node_id);
+    }
+}
+
+void StreamingETFeeder::resolve_parent(WindowNode& child) {
+    if (--child.unresolved_parents == 0) {
+        issuable_nodes.push(child.node->id());
+    }
+}
+
+void StreamingETFeeder::add_local_blocker(WindowNode& child) {
+    if (child.local_blockers++ == 0) {
+        ++num_blocked_nodes;
+    }
+}
+
+void StreamingETFeeder::remove_local_blocker(WindowNode& child) {
+    if (--child.local_blockers == 0) {
+        --num_blocked_nodes;
+    }
+}
+
+void StreamingETFeeder::drop_missing_parents() {
+    if (waiting_children.empty()) {
+        return;
+    }
+    uint64_t missing_deps = 0;
+    for (const auto& waiting : waiting_children) {
+        for (auto child_id : waiting.second) {
+            resolve_parent(window.at(child_id));
+            ++missing_deps;
+        }
+    }
+    waiting_children.clear();
+    LoggerFactory::get_logger("workload")
+        ->warn("{} dependencies on nodes missing from {} are ignored",
+               missing_deps, filename);
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __STREAMING_ET_FEEDER_HH__
+#define __STREAMING_ET_FEEDER_HH__
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/workload/WorkloadFeeder.hh"
+
+class ProtoInputStream;
+
+namespace AstraSim {
+
+// Feeds the nodes of a Chakra ET while reading it lazily. Only a window of
+// nodes that have been read but not yet retired is kept in memory, so that
+// memory does not grow with the length of the trace; nodes are read as the
+// window drains. Retired nodes are remembered in a bitmap over node ids
+// only.
+//
+// The window may exceed its size when none of the nodes in it can make
+// progress on their own, i.e. when they wait for parents later in the file
+// or for in-flight communication, which may wait in turn for nodes other
+// ranks have not read yet. Nodes waiting for a node in the window that can
+// still progress by itself hold the window at its size.
+class StreamingETFeeder : public WorkloadFeeder {
+  public:
+    StreamingETFeeder(const std::string& filename, uint64_t window_size);
+    ~StreamingETFeeder() override;
+
+    bool hasNodesToIssue() override;
+    std::shared_ptr<Chakra::ETFeederNode> getNextIssuableNode() override;
+    void pushBackIssuableNode(uint64_t node_id) override;
+    std::shared_ptr<Chakra::ETFeederNode> lookupNode(
+        uint64_t node_id) override;
+    void freeChildrenNodes(uint64_t node_id) override;
+    void removeNode(uint64_t node_id) override;
+
+  private:
+    struct WindowNode {
+        std::shared_ptr<Chakra::ETFeederNode> node;
+        uint32_t unresolved_parents;
+        // unresolved parents in the window other than in-flight comms
+        uint32_t local_blockers;
+        // issued communication, which may wait for other ranks
+        bool in_flight_comm;
+        std::vector<uint64_t> children;
+    };
+
+    // Read nodes until the window is full, or until some node in it can
+    // make progress.
+    void fill_window();
+    // whether nothing in the window progresses without reading further
+    bool window_stalled() const;
+    void read_node(ChakraProtoMsg::Node&& proto_node);
+    void resolve_parent(WindowNode& child);
+    void add_local_blocker(WindowNode& child);
+    void remove_local_blocker(WindowNode& child);
+    // dependencies on nodes missing from the ET never resolve
+    void drop_missing_parents();
+    bool is_resolved(uint64_t node_id) const {
+        return node_id < resolved.size() && resolved[node_id];
+    }
+
+    std::string filename;
+    uint64_t window_size;
+    std::unique_ptr<ProtoInputStream> et;
+    bool et_complete;
+
+    std::unordered_map<uint64_t, WindowNode> window;
+    // parent id not read yet -> children in the window waiting for it
+    std::unordered_map<uint64_t, std::vector<uint64_t>> waiting_children;
+    // issued in ascending id order, as Chakra::ETFeeder does
+    std::priority_queue<uint64_t,
+                        std::vector<uint64_t>,
+                        std::greater<uint64_t>>
+        issuable_nodes;
+    // nodes handed out by getNextIssuableNode and not yet retired
+    uint64_t num_issued_nodes;
+    // of which not communication
+    uint64_t num_issued_local_nodes;
+    // nodes in the window with local blockers
+    uint64_t num_blocked_nodes;
+    // node id -> whether the children of the node have been freed
+    std::vector<bool> resolved;
+};
+
+}  // namespace AstraSim
+
+#endif /* __STREAMING_ET_FEEDER_HH__ */
@@ -0,0 +1,461 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/TextWorkload.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "astra-sim/common/Logging.hh"
+#include <json/json.hpp>
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+typedef ChakraProtoMsg::NodeType ChakraNodeType;
+typedef ChakraProtoMsg::CollectiveCommType ChakraCollectiveCommType;
+
+namespace {
+
+mutex shared_workloads_mutex;
+map<string, shared_ptr<const TextWorkload>> shared_workloads;
+
+void text_panic(const string& msg) {
+    LoggerFactory::get_logger("workload")->critical(msg);
+    exit(EXIT_FAILURE);
+}
+
+vector<string> split(const string& line) {
+    vector<string> tokens;
+    istringstream iss(line);
+    string token;
+    while (iss >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+// last node of a phase: its collective if any, otherwise its compute
+int64_t tail(int64_t comm, int64_t comp) {
+    return comm >= 0 ? comm : comp;
+}
+
+void add_int_attr(ChakraProtoMsg::Node* node, const string& name, int value) {
+    auto attr = node->add_attr();
+    attr->set_name(name);
+    attr->set_int32_val(value);
+}
+
+// (peer, bytes) pairs, flattened
+void add_matrix_attr(ChakraProtoMsg::Node* node,
+                     const string& name,
+                     const vector<pair<int, int>>& matrix) {
+    auto attr = node->add_attr();
+    attr->set_name(name);
+    auto list = attr->mutable_int32_list();
+    for (const auto& [peer, bytes] : matrix) {
+        list->add_values(peer);
+        list->add_values(bytes);
+    }
+}
+
+}  // namespace
+
+bool TextWorkload::is_text_workload(const string& filename) {
+    const string suffix = ".txt";
+    return filename.size() >= suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(),
+                            suffix) == 0;
+}
+
+shared_ptr<const TextWorkload> TextWorkload::get_shared(
+    const string& filename) {
+    lock_guard<mutex> lock(shared_workloads_mutex);
+    auto it = shared_workloads.find(filename);
+    if (it == shared_workloads.end()) {
+        it = shared_workloads
+                 .emplace(filename, make_shared<TextWorkload>(filename))
+                 .first;
+    }
+    return it->second;
+}
+
+TextWorkload::TextWorkload(const string& filename) : filename(filename) {
+    ifstream inFile(filename);
+    if (!inFile) {
+        text_panic("workload file: " + filename + " does not exist");
+    }
+    const auto slash = filename.find_last_of('/');
+    const string dir =
+        (slash == string::npos) ? "" : filename.substr(0, slash + 1);
+
+    string line;
+    getline(inFile, line);
+    const auto header = split(line);
+    if (header.empty()) {
+        text_panic("text workload " + filename + ": missing parallelism type");
+    }
+    const string parallelism = header[0];
+    int num_passes = 1;
+    for (size_t i = 1; i + 1 < header.size(); i++) {
+        if (header[i] == "passes:") {
+            num_passes = stoi(header[i + 1]);
+        }
+    }
+
+    getline(inFile, line);
+    const auto count = split(line);
+    if (count.empty() || stoi(count[0]) <= 0) {
+        text_panic("text workload " + filename + ": invalid layer count");
+    }
+    const int num_layers = stoi(count[0]);
+
+    vector<Layer> layers;
+    while (static_cast<int>(layers.size()) < num_layers &&
+           getline(inFile, line)) {
+        if (split(line).empty()) {
+            continue;
+        }
+        layers.push_back(parse_layer(line, dir));
+    }
+    if (static_cast<int>(layers.size()) != num_layers) {
+        text_panic("text workload " + filename + ": expected " +
+                   to_string(num_layers) + " layers, found " +
+                   to_string(layers.size()));
+    }
+
+    vector<LayerNodes> prev(layers.size());
+    for (pass = 0; pass < num_passes; pass++) {
+        if (parallelism == "MICRO") {
+            build_micro(layers);
+        } else if (parallelism == "DATA") {
+            build_data_parallel(layers, prev);
+        } else if (parallelism == "MODEL") {
+            build_layer_parallel(layers, prev, false);
+        } else if (parallelism == "HYBRID_DATA_MODEL" ||
+                   parallelism == "HYBRID_MODEL_DATA" ||
+                   parallelism == "HYBRID_TRANSFORMER" ||
+                   parallelism == "HYBRID_CUSTOMIZED") {
+            build_layer_parallel(layers, prev, true);
+        } else {
+            text_panic("text workload " + filename +
+                       ": unsupported parallelism " + parallelism);
+        }
+    }
+    graph = SharedGraph::compile(nodes);
+    nodes.clear();
+    alltoall_files.clear();
+}
+
+TextWorkload::Layer TextWorkload::parse_layer(const string& line,
+                                              const string& dir) {
+    const auto tokens = split(line);
+    if (tokens.size() < 12) {
+        text_panic("text workload " + filename + ": malformed layer: " + line);
+    }
+    Layer layer;
+    layer.name = tokens[0];
+    layer.fwd_comp_time = stoull(tokens[2]);
+    layer.fwd_comm_type = tokens[3];
+    layer.fwd_comm_size = stoull(tokens[4]);
+    layer.ig_comp_time = stoull(tokens[5]);
+    layer.ig_comm_type = tokens[6];
+    layer.ig_comm_size = stoull(tokens[7]);
+    layer.wg_comp_time = stoull(tokens[8]);
+    layer.wg_comm_type = tokens[9];
+    layer.wg_comm_size = stoull(tokens[10]);
+    // tokens[11] is the update delay, which the converter ignores as well
+
+    // anything else without '=' (e.g. the per-layer parallelism of
+    // HYBRID_CUSTOMIZED) does not change the graph
+    for (size_t i = 12; i < tokens.size(); i++) {
+        const auto eq = tokens[i].find('=');
+        if (eq == string::npos) {
+            continue;
+        }
+        const string key = tokens[i].substr(0, eq);
+        const string value = tokens[i].substr(eq + 1);
+        if (key == "group") {
+            if (sscanf(value.c_str(), "%dx%d", &layer.mesh.group_x,
+                       &layer.mesh.group_y) != 2) {
+                text_panic("text workload " + filename +
+                           ": invalid group: " + value);
+            }
+        } else if (key == "part") {
+            if (sscanf(value.c_str(), "%dx%d", &layer.mesh.part_x,
+                       &layer.mesh.part_y) != 2) {
+                text_panic("text workload " + filename +
+                           ": invalid part: " + value);
+            }
+        } else if (key == "inter_part") {
+            layer.mesh.inter_part = (stoi(value) != 0);
+        } else if (key == "alltoall") {
+            layer.mesh.alltoall =
+                load_alltoall(value.front() == '/' ? value : dir + value);
+        } else {
+            text_panic("text workload " + filename +
+                       ": unknown layer attribute: " + key);
+        }
+    }
+    return layer;
+}
+
+TextWorkload::AllToAllBatches TextWorkload::load_alltoall(const string& path) {
+    auto it = alltoall_files.find(path);
+    if (it != alltoall_files.end()) {
+        return it->second;
+    }
+
+    ifstream inFile(path);
+    if (!inFile) {
+        text_panic("all-to-all matrix file: " + path + " does not exist");
+    }
+    json j;
+    inFile >> j;
+
+    auto parse_batch = [](const json& batch) {
+        auto matrices = make_shared<AllToAllMatrices>();
+        for (auto it = batch.begin(); it != batch.end(); ++it) {
+            auto& matrix = (*matrices)[stoi(it.key())];
+            if (it.value().contains("send")) {
+                for (const auto& entry : it.value()["send"]) {
+                    matrix.send.emplace_back(entry[0], entry[1]);
+                }
+            }
+            if (it.value().contains("recv")) {
+                for (const auto& entry : it.value()["recv"]) {
+                    matrix.recv.emplace_back(entry[0], entry[1]);
+                }
+            }
+        }
+        return matrices;
+    };
+    AllToAllBatches batches;
+    if (j.contains("batches")) {
+        for (const auto& batch : j["batches"]) {
+            batches.push_back(parse_batch(batch));
+        }
+        if (batches.empty()) {
+            text_panic("all-to-all matrix file: " + path + " has no batches");
+        }
+    } else {
+        batches.push_back(parse_batch(j));
+    }
+    alltoall_files.emplace(path, batches);
+    return batches;
+}
+
+int64_t TextWorkload::add_node(const string& name,
+                               ChakraNodeType type,
+                               const vector<int64_t>& deps) {
+    const int64_t id = nodes.size();
+    auto& node = nodes.emplace_back();
+    node.set_id(id);
+    node.set_name(name);
+    node.set_type(type);
+    auto attr = node.add_attr();
+    attr->set_name("is_cpu_op");
+    attr->set_bool_val(false);
+    for (auto dep : deps) {
+        if (dep >= 0) {
+            node.add_data_deps(dep);
+        }
+    }
+    return id;
+}
+
+int64_t TextWorkload::add_comp(const Layer& layer,
+                               const string& phase,
+                               uint64_t comp_time,
+                               const vector<int64_t>& deps) {
+    const auto id = add_node("COMP_NODE_" + layer.name + "_" + phase,
+                             ChakraNodeType::COMP_NODE, deps);
+    nodes[id].set_duration_micros(comp_time);
+    return id;
+}
+
+int64_t TextWorkload::add_comm(const Layer& layer,
+                               const string& comm_type,
+                               uint64_t comm_size,
+                               const vector<int64_t>& deps) {
+    ChakraCollectiveCommType type;
+    if (comm_type == "NONE") {
+        // the Chakra text converter emits an all-reduce of the given size,
+        // 0, in place of no communication
+        type = ChakraCollectiveCommType::ALL_REDUCE;
+    } else if (comm_type == "ALLREDUCE") {
+        type = ChakraCollectiveCommType::ALL_REDUCE;
+    } else if (comm_type == "ALLGATHER") {
+        type = ChakraCollectiveCommType::ALL_GATHER;
+    } else if (comm_type == "REDUCESCATTER") {
+        type = ChakraCollectiveCommType::REDUCE_SCATTER;
+    } else if (comm_type == "ALLTOALL") {
+        type = ChakraCollectiveCommType::ALL_TO_ALL;
+    } else {
+        text_panic("text workload " + filename +
+                   ": unknown communication type " + comm_type);
+        return -1;
+    }
+
+    const auto id =
+        add_node("COMM_COLL_NODE_" + layer.name + "_" + comm_type,
+                 ChakraNodeType::COMM_COLL_NODE, deps);
+    auto node = &nodes[id];
+    auto attr = node->add_attr();
+    attr->set_name("comm_type");
+    attr->set_int64_val(type);
+    attr = node->add_attr();
+    attr->set_name("comm_size");
+    attr->set_int64_val(comm_size);
+
+    if (layer.mesh.group_x > 0) {
+        add_int_attr(node, "group_x", layer.mesh.group_x);
+        add_int_attr(node, "group_y", layer.mesh.group_y);
+    }
+    if (layer.mesh.part_x > 0) {
+        add_int_attr(node, "part_x", layer.mesh.part_x);
+        add_int_attr(node, "part_y", layer.mesh.part_y);
+    }
+    if (layer.mesh.inter_part) {
+        attr = node->add_attr();
+        attr->set_name("inter_part");
+        attr->set_bool_val(true);
+    }
+    if (!layer.mesh.alltoall.empty() &&
+        type == ChakraCollectiveCommType::ALL_TO_ALL) {
+        alltoall_matrices[id] =
+            layer.mesh.alltoall[pass % layer.mesh.alltoall.size()];
+    }
+    return id;
+}
+
+void TextWorkload::build_micro(const vector<Layer>& layers) {
+    for (const auto& layer : layers) {
+        add_comm(layer, layer.wg_comm_type, layer.wg_comm_size, {});
+    }
+}
+
+void TextWorkload::build_data_parallel(const vector<Layer>& layers,
+                                       vector<LayerNodes>& prev) {
+    vector<LayerNodes> cur(layers.size());
+    for (size_t i = 0; i < layers.size(); i++) {
+        const auto& layer = layers[i];
+        cur[i].fwd_comp = add_comp(
+            layer, "FWD", layer.fwd_comp_time,
+            {i > 0 ? cur[i - 1].fwd_comp : -1,
+             tail(prev[i].wg_comm, prev[i].wg_comp)});
+    }
+
+    // backward pass: weight gradients first, each followed by its
+    // all-reduce, then the input gradients feeding the previous layer
+    int64_t frontier = cur.back().fwd_comp;
+    for (size_t k = layers.size(); k-- > 0;) {
+        const auto& layer = layers[k];
+        cur[k].wg_comp =
+            add_comp(layer, "BWD_WG", layer.wg_comp_time, {frontier});
+        cur[k].wg_comm = add_comm(layer, layer.wg_comm_type,
+                                  layer.wg_comm_size, {cur[k].wg_comp});
+        if (k > 0) {
+            cur[k].ig_comp =
+                add_comp(layer, "BWD_IG", layer.ig_comp_time, {cur[k].wg_comp});
+            frontier = cur[k].ig_comp;
+        }
+    }
+    prev = move(cur);
+}
+
+void TextWorkload::build_layer_parallel(const vector<Layer>& layers,
+                                        vector<LayerNodes>& prev,
+                                        bool wg_comm) {
+    vector<LayerNodes> cur(layers.size());
+    for (size_t i = 0; i < layers.size(); i++) {
+        const auto& layer = layers[i];
+        cur[i].fwd_comp = add_comp(
+            layer, "FWD", layer.fwd_comp_time,
+            {i > 0 ? tail(cur[i - 1].fwd_comm, cur[i - 1].fwd_comp) : -1,
+             tail(prev[i].wg_comm, prev[i].wg_comp)});
+        cur[i].fwd_comm = add_comm(layer, layer.fwd_comm_type,
+                                   layer.fwd_comm_size, {cur[i].fwd_comp});
+    }
+
+    // backward pass: input gradients first, then weight gradients; the
+    // first layer has no input gradient to compute
+    vector<int64_t> frontier = {
+        tail(cur.back().fwd_comm, cur.back().fwd_comp)};
+    for (size_t k = layers.size(); k-- > 0;) {
+        const auto& layer = layers[k];
+        if (k > 0) {
+            cur[k].ig_comp =
+                add_comp(layer, "BWD_IG", layer.ig_comp_time, frontier);
+            cur[k].ig_comm = add_comm(layer, layer.ig_comm_type,
+                                      layer.ig_comm_size, {cur[k].ig_comp});
+            cur[k].wg_comp = add_comp(layer, "BWD_WG", layer.wg_comp_time,
+                                      {cur[k].ig_comp});
+        } else {
+            cur[k].wg_comp =
+                add_comp(layer, "BWD_WG", layer.wg_comp_time, frontier);
+        }
+        if (wg_comm) {
+            cur[k].wg_comm = add_comm(layer, layer.wg_comm_type,
+                                      layer.wg_comm_size, {cur[k].wg_comp});
+        }
+        frontier = {cur[k].wg_comp, tail(cur[k].ig_comm, cur[k].ig_comp)};
+    }
+    prev = move(cur);
+}
+
+shared_ptr<const SharedGraph::Overlay> TextWorkload::overlay(int rank) const {
+    auto overlay = make_shared<SharedGraph::Overlay>();
+    for (const auto& [node_id, matrices] : alltoall_matrices) {
+        auto matrix = matrices->find(rank);
+        if (matrix == matrices->end()) {
+            continue;
+        }
+        ChakraProtoMsg::Node attrs;
+        add_matrix_attr(&attrs, "alltoall_send_matrix", matrix->second.send);
+        add_matrix_attr(&attrs, "alltoall_recv_matrix", matrix->second.recv);
+        auto& node_overlay = (*overlay)[node_id];
+        node_overlay.assign(attrs.attr().begin(), attrs.attr().end());
+    }
+    return overlay;
+}
+
+uint64_t TextWorkload::rank_digest(int rank) const {
+    vector<uint64_t> node_ids;
+    for (const auto& entry : alltoall_matrices) {
+        node_ids.push_back(entry.first);
+    }
+    sort(node_ids.begin(), node_ids.end());
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    for (auto node_id : node_ids) {
+        const auto& matrices = *alltoall_matrices.at(node_id);
+        auto matrix = matrices.find(rank);
+        mix(node_id);
+        if (matrix == matrices.end()) {
+            continue;
+        }
+        for (const auto& [peer, bytes] : matrix->second.send) {
+            mix(peer);
+            mix(bytes);
+        }
+        mix(~0ULL);
+        for (const auto& [peer, bytes] : matrix->second.recv) {
+            mix(peer);
+            mix(bytes);
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __TEXT_WORKLOAD_HH__
+#define __TEXT_WORKLOAD_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+#include "astra-sim/workload/SharedGraph.hh"
+
+namespace AstraSim {
+
+// Workload in the text format of examples/text_converter/text_workloads,
+// unrolled into a Chakra node graph in memory instead of being converted
+// to per-rank ET files. The graph is identical on every rank, so it is
+// built once per file and shared; the all-to-all traffic matrices, which
+// differ across ranks, go to per-rank overlays.
+//
+// Besides the twelve columns of a layer, a layer line may carry
+// "key=value" tokens that apply to the MeshXY collectives of that layer:
+//   group=<x>x<y>     EP group shape
+//   part=<x>x<y>      partition shape within the group
+//   inter_part=<0|1>  communicate across partitions
+//   alltoall=<file>   per-rank all-to-all traffic, as JSON
+//                     {"<rank>": {"send": [[dst, bytes], ...],
+//                                 "recv": [[src, bytes], ...]}}
+//                     or, to vary it across batches,
+//                     {"batches": [{"<rank>": ...}, ...]}
+// The first line may carry "passes: <n>" to unroll n training passes. Pass
+// p runs batch p of an all-to-all file, wrapping around.
+class TextWorkload {
+  public:
+    // rank -> all-to-all traffic of that rank
+    using AllToAllMatrices = std::unordered_map<int, AllToAllMatrix>;
+    // the traffic of each batch
+    using AllToAllBatches = std::vector<std::shared_ptr<const AllToAllMatrices>>;
+
+    static bool is_text_workload(const std::string& filename);
+    // Parses each file once per process, returns the shared graph.
+    static std::shared_ptr<const TextWorkload> get_shared(
+        const std::string& filename);
+
+    explicit TextWorkload(const std::string& filename);
+
+    // Attributes of 'rank' on top of the shared graph.
+    std::shared_ptr<const SharedGraph::Overlay> overlay(int rank) const;
+    // Digest of everything that differs between ranks, i.e. their
+    // all-to-all traffic. Ranks with equal digests run identical graphs.
+    uint64_t rank_digest(int rank) const;
+
+    std::string filename;
+    // node i has id i
+    std::shared_ptr<const SharedGraph> graph;
+    // all-to-all node id -> traffic of each rank
+    std::unordered_map<uint64_t, std::shared_ptr<const AllToAllMatrices>>
+        alltoall_matrices;
+
+  private:
+    struct MeshAttrs {
+        int group_x = 0;
+        int group_y = 0;
+        int part_x = 0;
+        int part_y = 0;
+        bool inter_part = false;
+        AllToAllBatches alltoall;
+    };
+    struct Layer {
+        std::string name;
+        uint64_t fwd_comp_time;
+        std::string fwd_comm_type;
+        uint64_t fwd_comm_size;
+        uint64_t ig_comp_time;
+        std::string ig_comm_type;
+        uint64_t ig_comm_size;
+        uint64_t wg_comp_time;
+        std::string wg_comm_type;
+        uint64_t wg_comm_size;
+        MeshAttrs mesh;
+    };
+    // ids of the nodes of a layer in the current pass, -1 if absent
+    struct LayerNodes {
+        int64_t fwd_comp = -1;
+        int64_t fwd_comm = -1;
+        int64_t ig_comp = -1;
+        int64_t ig_comm = -1;
+        int64_t wg_comp = -1;
+        int64_t wg_comm = -1;
+    };
+
+    Layer parse_layer(const std::string& line, const std::string& dir);
+    AllToAllBatches load_alltoall(const std::string& path);
+
+    void build_micro(const std::vector<Layer>& layers);
+    void build_data_parallel(const std::vector<Layer>& layers,
+                             std::vector<LayerNodes>& prev);
+    void build_layer_parallel(const std::vector<Layer>& layers,
+                              std::vector<LayerNodes>& prev,
+                              bool wg_comm);
+
+    int64_t add_node(const std::string& name,
+                     ChakraProtoMsg::NodeType type,
+                     const std::vector<int64_t>& deps);
+    int64_t add_comp(const Layer& layer,
+                     const std::string& phase,
+                     uint64_t comp_time,
+                     const std::vector<int64_t>& deps);
+    // NONE adds an all-reduce of 'comm_size' bytes, as the Chakra text
+    // converter does
+    int64_t add_comm(const Layer& layer,
+                     const std::string& comm_type,
+                     uint64_t comm_size,
+                     const std::vector<int64_t>& deps);
+
+    // while parsing
+    std::vector<ChakraProtoMsg::Node> nodes;
+    std::unordered_map<std::string, AllToAllBatches> alltoall_files;
+    int pass = 0;
+};
+
+}  // namespace AstraSim
+
+#endif /* __TEXT_WORKLOAD_HH__ */
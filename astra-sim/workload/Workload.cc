@@ -6,13 +6,20 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/workload/Workload.hh"
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/ComputeModel.hh"
 #include "astra-sim/system/IntData.hh"
 #include "astra-sim/system/MemEventHandlerData.hh"
 #include "astra-sim/system/RecvPacketEventHandlerData.hh"
 #include "astra-sim/system/SendPacketEventHandlerData.hh"
+#include "astra-sim/system/SimProfiler.hh"
+#include "astra-sim/system/SystemConfig.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
+#include "astra-sim/workload/GraphStore.hh"
+#include "astra-sim/workload/StreamingETFeeder.hh"
+#include "astra-sim/workload/TextWorkload.hh"
 #include <json/json.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 #include <unistd.h>
@@ -26,29 +33,31 @@ typedef ChakraProtoMsg::NodeType ChakraNodeType;
 typedef ChakraProtoMsg::CollectiveCommType ChakraCollectiveCommType;
 
 Workload::Workload(Sys* sys, string et_filename, string comm_group_filename) {
-    string workload_filename = et_filename + "." + to_string(sys->id) + ".et";
-    // Check if workload filename exists
-    if (access(workload_filename.c_str(), R_OK) < 0) {
-        string error_msg;
-        if (errno == ENOENT) {
-            error_msg =
-                "workload file: " + workload_filename + " does not exist";
-        } else if (errno == EACCES) {
-            error_msg = "workload file: " + workload_filename +
-                        " exists but is not readable";
-        } else {
-            error_msg =
-                "Unknown workload file: " + workload_filename + " access error";
-        }
-        LoggerFactory::get_logger("workload")->critical(error_msg);
-        exit(EXIT_FAILURE);
+    const auto& system_config = *sys->system_config;
+    if (system_config.workload_window > 0 &&
+        !TextWorkload::is_text_workload(et_filename)) {
+        // long traces are streamed instead of being held in memory whole
+        this->et_feeder = new StreamingETFeeder(
+            GraphStore::chakra_et_filename(et_filename, sys->id),
+            system_config.workload_window);
+        this->et_streamed = true;
+    } else {
+        auto rank_graph = GraphStore::load(et_filename, sys->id,
+                                           system_config.workload_cache_dir);
+        this->et_feeder =
+            new SharedGraphFeeder(rank_graph.graph, rank_graph.overlay);
+        this->et_streamed = false;
     }
-    this->et_feeder = new ETFeeder(workload_filename);
     this->comm_groups.clear();
-    // TODO: parametrize the number of available hardware resources
-    this->hw_resource = new HardwareResource(1);
+    this->hw_resource =
+        new HardwareResource(1, system_config.compute_streams,
+                             system_config.comm_streams);
+    this->ready_queues.resize(hw_resource->num_ready_queues());
     this->sys = sys;
+    const auto comm_group_start = chrono::steady_clock::now();
     initialize_comm_groups(comm_group_filename);
+    SimProfiler::add_startup_seconds(SimProfiler::comm_group_seconds,
+                                     comm_group_start);
     this->is_finished = false;
 }
 
@@ -92,21 +101,58 @@ void Workload::initialize_comm_groups(string comm_group_filename) {
 }
 
 void Workload::issue_dep_free_nodes() {
-    std::queue<shared_ptr<Chakra::ETFeederNode>> push_back_queue;
-    shared_ptr<Chakra::ETFeederNode> node = et_feeder->getNextIssuableNode();
-    while (node != nullptr) {
-        if (hw_resource->is_available(node)) {
-            issue(node);
-        } else {
-            push_back_queue.push(node);
+    vector<shared_ptr<Chakra::ETFeederNode>> issuable;
+    while (true) {
+        shared_ptr<Chakra::ETFeederNode> node =
+            et_feeder->getNextIssuableNode();
+        while (node != nullptr) {
+            ready_queues[hw_resource->ready_queue_of(node)].push(node);
+            node = et_feeder->getNextIssuableNode();
         }
-        node = et_feeder->getNextIssuableNode();
-    }
 
-    while (!push_back_queue.empty()) {
-        shared_ptr<Chakra::ETFeederNode> node = push_back_queue.front();
-        et_feeder->pushBackIssuableNode(node->id());
-        push_back_queue.pop();
+        // every queue whose head can run hands it out; nodes behind a busy
+        // resource are left alone until it is released
+        issuable.clear();
+        for (auto& ready_queue : ready_queues) {
+            if (ready_queue.empty()) {
+                continue;
+            }
+            if (!hw_resource->is_available(ready_queue.top())) {
+                ++SimProfiler::workload_wasted_examinations;
+                SimProfiler::workload_avoided_examinations +=
+                    ready_queue.size() - 1;
+                continue;
+            }
+            do {
+                issuable.push_back(ready_queue.top());
+                ready_queue.pop();
+            } while (!ready_queue.empty() &&
+                     HardwareResource::resource_of(ready_queue.top()) ==
+                         HardwareResource::Recv);
+        }
+        if (issuable.empty()) {
+            break;
+        }
+
+        // issue in id order, as the feeder hands nodes out. Heads of the
+        // queues of one resource may compete for its last free stream; the
+        // losers wait again. Nodes issued without occupying their resource,
+        // such as invalid ones, and further free streams are handled in the
+        // next round.
+        sort(issuable.begin(), issuable.end(),
+             [](const shared_ptr<Chakra::ETFeederNode>& a,
+                const shared_ptr<Chakra::ETFeederNode>& b) {
+                 return a->id() < b->id();
+             });
+        for (const auto& issuable_node : issuable) {
+            if (hw_resource->is_available(issuable_node)) {
+                issue(issuable_node);
+            } else {
+                ++SimProfiler::workload_wasted_examinations;
+                ready_queues[hw_resource->ready_queue_of(issuable_node)].push(
+                    issuable_node);
+            }
+        }
     }
 }
 
@@ -162,14 +208,26 @@ void Workload::issue(shared_ptr<Chakra::ETFeederNode> node) {
 }
 
 void Workload::issue_replay(shared_ptr<Chakra::ETFeederNode> node) {
-    WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
-    wlhd->node_id = node->id();
     uint64_t runtime = 1ul;
     if (node->runtime() != 0ul) {
         // chakra runtimes are in microseconds and we should convert it into
         // nanoseconds
         runtime = node->runtime() * 1000;
     }
+    issue_runtime(node, runtime);
+}
+
+void Workload::issue_runtime(shared_ptr<Chakra::ETFeederNode> node,
+                             uint64_t runtime) {
+    WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
+    wlhd->node_id = node->id();
+    // replay_only replays every node, but only compute is scaled
+    const auto resource = HardwareResource::resource_of(node);
+    if (resource == HardwareResource::CPU ||
+        resource == HardwareResource::GPUComp) {
+        runtime =
+            sys->compute_model->scale(node->name(), node->type(), runtime);
+    }
     if (node->is_cpu_op()) {
         hw_resource->tics_cpu_ops += runtime;
     } else {
@@ -191,23 +249,19 @@ void Workload::issue_remote_mem(shared_ptr<Chakra::ETFeederNode> node) {
 void Workload::issue_comp(shared_ptr<Chakra::ETFeederNode> node) {
     hw_resource->occupy(node);
 
-    if (sys->roofline_enabled) {
-        WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
-        wlhd->node_id = node->id();
-
+    // measured kernel durations first, then the roofline, then the ET
+    uint64_t runtime = 0;
+    if (sys->compute_model->get_runtime(node->name(), node->num_ops(),
+                                        node->tensor_size(), runtime)) {
+        issue_runtime(node, runtime);
+    } else if (sys->roofline_enabled) {
         double operational_intensity = static_cast<double>(node->num_ops()) /
                                        static_cast<double>(node->tensor_size());
         double perf = sys->roofline->get_perf(operational_intensity);
         double elapsed_time =
             static_cast<double>(node->num_ops()) / perf;  // sec
-        uint64_t runtime =
-            static_cast<uint64_t>(elapsed_time * 1e9);  // sec -> ns
-        if (node->is_cpu_op()) {
-            hw_resource->tics_cpu_ops += runtime;
-        } else {
-            hw_resource->tics_gpu_ops += runtime;
-        }
-        sys->register_event(this, EventType::General, wlhd, runtime);
+        runtime = static_cast<uint64_t>(elapsed_time * 1e9);  // sec -> ns
+        issue_runtime(node, runtime);
     } else {
         // advance this node forward the recorded "replayed" time specificed in
         // the ET.
@@ -255,10 +309,13 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
         if (node->comm_type() == ChakraCollectiveCommType::ALL_REDUCE) {
             DataSet* fp =
                 sys->generate_all_reduce(node->comm_size(), involved_dim,
-                                         comm_group, node->comm_priority());
-            collective_comm_node_id_map[fp->my_id] = node->id();
-            collective_comm_wrapper_map[fp->my_id] = fp;
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+                                         comm_group, node->comm_priority(),
+                                        node->group_x(),
+                                        node->group_y(),
+                                        node->part_x(),
+                                        node->part_y(),
+                                        node->inter_part());
+            track_collective(fp, node->id());
 
         } else if (node->comm_type() == ChakraCollectiveCommType::ALL_TO_ALL) {
             DataSet* fp =
@@ -269,11 +326,10 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
                                         node->part_x(),
                                         node->part_y(),
                                         node->inter_part(),
-                                        node->alltoall_send_matrix(),
-                                        node->alltoall_recv_matrix());
-            collective_comm_node_id_map[fp->my_id] = node->id();
-            collective_comm_wrapper_map[fp->my_id] = fp;
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+                                        make_shared<const AllToAllMatrix>(
+                                            AllToAllMatrix{node->alltoall_send_matrix(),
+                                                           node->alltoall_recv_matrix()}));
+            track_collective(fp, node->id());
 
         } else if (node->comm_type() == ChakraCollectiveCommType::ALL_GATHER) {
             DataSet* fp =
@@ -284,9 +340,7 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
                                         node->part_x(),
                                         node->part_y(),
                                         node->inter_part());
-            collective_comm_node_id_map[fp->my_id] = node->id();
-            collective_comm_wrapper_map[fp->my_id] = fp;
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+            track_collective(fp, node->id());
 
         } else if (node->comm_type() ==
                    ChakraCollectiveCommType::REDUCE_SCATTER) {
@@ -298,9 +352,7 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
                                             node->part_x(),
                                             node->part_y(),
                                             node->inter_part());
-            collective_comm_node_id_map[fp->my_id] = node->id();
-            collective_comm_wrapper_map[fp->my_id] = fp;
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+            track_collective(fp, node->id());
 
         } else if (node->comm_type() == ChakraCollectiveCommType::BROADCAST) {
             // broadcast colelctive has not been implemented in ASTRA-SIM yet.
@@ -312,14 +364,11 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
                 runtime = node->runtime() * 1000;
             }
             DataSet* fp = new DataSet(1);
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
-            collective_comm_node_id_map[fp->my_id] = node->id();
-            collective_comm_wrapper_map[fp->my_id] = fp;
+            track_collective(fp, node->id());
             sys->register_event(fp, EventType::General, nullptr,
                                 // chakra runtimes are in microseconds and we
                                 // should convert it into nanoseconds
                                 runtime);
-            fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
         }
     } else if (node->type() == ChakraNodeType::COMM_SEND_NODE) {
         sim_request snd_req;
@@ -353,6 +402,17 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
     }
 }
 
+void Workload::track_collective(DataSet* dataset, uint64_t node_id) {
+    if (free_collective_ids.empty()) {
+        free_collective_ids.push_back(static_cast<int>(collectives.size()));
+        collectives.emplace_back();
+    }
+    dataset->my_id = free_collective_ids.back();
+    free_collective_ids.pop_back();
+    collectives[dataset->my_id] = {node_id, dataset};
+    dataset->set_notifier(this, EventType::CollectiveCommunicationFinished);
+}
+
 void Workload::skip_invalid(shared_ptr<Chakra::ETFeederNode> node) {
     et_feeder->freeChildrenNodes(node->id());
     et_feeder->removeNode(node->id());
@@ -365,10 +425,12 @@ void Workload::call(EventType event, CallData* data) {
 
     if (event == EventType::CollectiveCommunicationFinished) {
         IntData* int_data = (IntData*)data;
-        uint64_t coll_comm_id = int_data->data;
+        int collective_id = int_data->data;
 
         hw_resource->tics_gpu_comms += int_data->execution_time;
-        uint64_t node_id = collective_comm_node_id_map[coll_comm_id];
+        // copied, as collectives issued below may grow the slots
+        const InFlightCollective collective = collectives[collective_id];
+        uint64_t node_id = collective.node_id;
         shared_ptr<Chakra::ETFeederNode> node = et_feeder->lookupNode(node_id);
 
         if (sys->trace_enabled) {
@@ -387,8 +449,8 @@ void Workload::call(EventType event, CallData* data) {
       
         // The Dataset class provides statistics that should be used later to dump
         // more statistics in the workload layer
-        delete collective_comm_wrapper_map[coll_comm_id];
-        collective_comm_wrapper_map.erase(coll_comm_id);
+        delete collective.dataset;
+        free_collective_ids.push_back(collective_id);
         et_feeder->removeNode(node_id);
 
     } else {
@@ -425,18 +487,33 @@ void Workload::call(EventType event, CallData* data) {
         report();
         sys->comm_NI->sim_notify_finished();
         is_finished = true;
+        SimProfiler::notify_workload_finished(Sys::num_active_sys());
     }
 }
 
 void Workload::fire() {
+    SimProfiler::start();
     call(EventType::General, NULL);
 }
 
 void Workload::report() {
     Tick curr_tick = Sys::boostedTick();
+    Tick comp_ticks = hw_resource->gpu_comp_ticks();
     LoggerFactory::get_logger("workload")
         ->info("sys[{}] finished, {} cycles, exposed communication {} cycles.",
-               sys->id, curr_tick, curr_tick - hw_resource->tics_gpu_ops);
+               sys->id, curr_tick, curr_tick - comp_ticks);
+    for (int rank : sys->represented_ranks) {
+        LoggerFactory::get_logger("workload")
+            ->info("sys[{}] finished, {} cycles, exposed communication {} "
+                   "cycles.",
+                   rank, curr_tick, curr_tick - comp_ticks);
+    }
+    if (hw_resource->num_streams(HardwareResource::GPUComp) > 1 ||
+        hw_resource->num_streams(HardwareResource::GPUComm) > 1) {
+        LoggerFactory::get_logger("workload")
+            ->info("sys[{}] stream occupancy: {}", sys->id,
+                   hw_resource->stream_occupancy(curr_tick));
+    }
 }
 
 CommunicatorGroup* Workload::extract_comm_group(std::shared_ptr<Chakra::ETFeederNode> node) {
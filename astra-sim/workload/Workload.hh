@@ -7,13 +7,15 @@ LICENSE file in the root directory of this source tree.
 #define __WORKLOAD_HH__
 
 #include <memory>
+#include <queue>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CommunicatorGroup.hh"
 #include "astra-sim/workload/HardwareResource.hh"
-#include "extern/graph_frontend/chakra/src/feeder/et_feeder.h"
+#include "astra-sim/workload/WorkloadFeeder.hh"
 
 namespace AstraSim {
 
@@ -38,6 +40,10 @@ class Workload : public Callable {
     void issue_replay(std::shared_ptr<Chakra::ETFeederNode> node);
     void issue_remote_mem(std::shared_ptr<Chakra::ETFeederNode> node);
     void issue_comp(std::shared_ptr<Chakra::ETFeederNode> node);
+    // complete a compute node after 'runtime' ns, scaled by the compute
+    // scale of the node
+    void issue_runtime(std::shared_ptr<Chakra::ETFeederNode> node,
+                       uint64_t runtime);
     void issue_comm(std::shared_ptr<Chakra::ETFeederNode> node);
     void skip_invalid(std::shared_ptr<Chakra::ETFeederNode> node);
     void call(EventType event, CallData* data);
@@ -46,15 +52,45 @@ class Workload : public Callable {
     // stats
     void report();
 
-    Chakra::ETFeeder* et_feeder;
+    WorkloadFeeder* et_feeder;
     std::unordered_map<int, CommunicatorGroup*> comm_groups;
     HardwareResource* hw_resource;
     Sys* sys;
-    std::unordered_map<int, uint64_t> collective_comm_node_id_map;
-    std::unordered_map<int, DataSet*> collective_comm_wrapper_map;
     bool is_finished;
+    // the ET is streamed through a window rather than loaded whole
+    bool et_streamed;
 
     private:
+    // collective node waiting for a DataSet of the system layer
+    struct InFlightCollective {
+        uint64_t node_id;
+        DataSet* dataset;
+    };
+    // Give 'dataset' a free slot of 'collectives' as its id, and get
+    // notified when it finishes.
+    void track_collective(DataSet* dataset, uint64_t node_id);
+
+    // in-flight collectives indexed by the id of their DataSet; ids are
+    // reused, so there are only as many slots as collectives ever in flight
+    std::vector<InFlightCollective> collectives;
+    std::vector<int> free_collective_ids;
+
+    struct NodeIdGreater {
+        bool operator()(const std::shared_ptr<Chakra::ETFeederNode>& a,
+                        const std::shared_ptr<Chakra::ETFeederNode>& b) const {
+            return a->id() > b->id();
+        }
+    };
+    // Dependency-free nodes waiting for their hardware resource, lowest id
+    // first. A node is examined when it becomes dependency-free and then
+    // only once it reaches the head of its queue while the resource is free
+    // (HardwareResource::ready_queue_of).
+    std::vector<
+        std::priority_queue<std::shared_ptr<Chakra::ETFeederNode>,
+                            std::vector<std::shared_ptr<Chakra::ETFeederNode>>,
+                            NodeIdGreater>>
+        ready_queues;
+
     // From the ET node, find out the corresponding communicator group, and return the pointer.
     // If no communicator group is specified for this ET node, return nullptr.
     CommunicatorGroup* extract_comm_group(std::shared_ptr<Chakra::ETFeederNode> node);
@@ -0,0 +1,34 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __WORKLOAD_FEEDER_HH__
+#define __WORKLOAD_FEEDER_HH__
+
+#include <cstdint>
+#include <memory>
+
+#include "extern/graph_frontend/chakra/src/feeder/et_feeder_node.h"
+
+namespace AstraSim {
+
+// Source of the nodes a Workload issues. The interface mirrors
+// Chakra::ETFeeder, so that nodes are issued and retired the same way
+// whichever way the graph behind them is stored.
+class WorkloadFeeder {
+  public:
+    virtual ~WorkloadFeeder() = default;
+
+    virtual bool hasNodesToIssue() = 0;
+    virtual std::shared_ptr<Chakra::ETFeederNode> getNextIssuableNode() = 0;
+    virtual void pushBackIssuableNode(uint64_t node_id) = 0;
+    virtual std::shared_ptr<Chakra::ETFeederNode> lookupNode(
+        uint64_t node_id) = 0;
+    virtual void freeChildrenNodes(uint64_t node_id) = 0;
+    virtual void removeNode(uint64_t node_id) = 0;
+};
+
+}  // namespace AstraSim
+
+#endif /* __WORKLOAD_FEEDER_HH__ */
@@ -39,6 +39,7 @@ Actions (exactly one):
   build_chakra                   Build & install Chakra (pip install .)
   run_chakra         -b <N>      Launch N chakra runs with --index=0..N-1
   run_astra          -b <N>      Launch N astra runs with --index=0..N-1
+  run_astra_text                 Run astra directly on the text workload
 
 Examples:
   $0 build_astra
@@ -46,6 +47,7 @@ Examples:
   $0 build_chakra
   $0 run_chakra -b 4
   $0 run_astra -b 8
+  $0 run_astra_text
 EOF
 }
 
@@ -147,6 +149,18 @@ case "$ACTION" in
     echo "[ASTRA-sim] All runs finished."
     ;;
 
+  run_astra_text)
+    # The text workload is read natively; no chakra conversion needed.
+    echo "[RUN][astra] ${ASTRA_SIM} --workload-configuration=${WORKLOAD_TXT} --system-configuration=${SYSTEM} --remote-memory-configuration=${REMOTE_MEMORY} --network-configuration=${NETWORK} --log-output-path=${LOG_OUTPUT_PREFIX}_text.txt"
+    "${ASTRA_SIM}" \
+      --workload-configuration="${WORKLOAD_TXT}" \
+      --system-configuration="${SYSTEM}" \
+      --remote-memory-configuration="${REMOTE_MEMORY}" \
+      --network-configuration="${NETWORK}" \
+      --log-output-path="${LOG_OUTPUT_PREFIX}_text.txt"
+    echo "[ASTRA-sim] Run finished."
+    ;;
+
   *)
     echo "Unknown action: ${ACTION}" >&2
     usage
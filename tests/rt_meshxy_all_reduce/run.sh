@@ -0,0 +1,53 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+)
+
+# Run ASTRA-sim
+# (from outputs, where the logging configuration writes meshxy.log)
+(
+echo "[$0] Running ASTRA-sim..."
+cd ${SCRIPT_DIR}/outputs
+${ASTRA_SIM_BIN} \
+    --workload-configuration=${SCRIPT_DIR}/inputs/workload/all_reduce.txt \
+    --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+    --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+    --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+    --logging-configuration=${SCRIPT_DIR}/inputs/logging_cfg.toml \
+    --log-output-path=${SCRIPT_DIR}/outputs/log.txt \
+	| tee ${SCRIPT_DIR}/outputs/stdout.txt
+)
+
+msg_sizes() {
+    sed -nE 's/.*<system::collective::MeshXY>: id:([0-9]+) .*x_msg_size:([0-9]+), y_msg_size:([0-9]+)$/id:\1 x_msg_size:\2 y_msg_size:\3/p' \
+        | sort -t: -k2,2n
+}
+
+sends() {
+    sed -nE 's/.*<system::collective::MeshXY>: id:([0-9]+), instance:[0-9]+, stage:([0-9]+), sub-chunk:([0-9]+), send packet to: ([0-9]+), size: ([0-9]+)$/id:\1 stage:\2 sub-chunk:\3 dst:\4 size:\5/p' \
+        | sort -t' ' -k1.4,1n -k2.7,2n -k3.11,3n -k4.5,4n
+}
+
+finished() {
+    sed -nE 's/.*(sys\[[0-9]+\] finished),.*/\1/p' | sort -t[ -k2n
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+msg_sizes < ${SCRIPT_DIR}/outputs/meshxy.log > ${SCRIPT_DIR}/outputs/msg_sizes.txt
+diff ${SCRIPT_DIR}/outputs/msg_sizes.txt ${SCRIPT_DIR}/refs/msg_sizes.txt || (echo "Failed." ; exit 1)
+sends < ${SCRIPT_DIR}/outputs/meshxy.log > ${SCRIPT_DIR}/outputs/sends.txt
+diff ${SCRIPT_DIR}/outputs/sends.txt ${SCRIPT_DIR}/refs/sends.txt || (echo "Failed." ; exit 1)
+finished < ${SCRIPT_DIR}/outputs/stdout.txt > ${SCRIPT_DIR}/outputs/finished.txt
+diff ${SCRIPT_DIR}/outputs/finished.txt ${SCRIPT_DIR}/refs/finished.txt || (echo "Failed." ; exit 1)
+)
+
+echo "[$0] Ok."
@@ -0,0 +1,55 @@
+import os
+
+from chakra.src.third_party.utils.protolib import encodeMessage as encode_message
+from chakra.schema.protobuf.et_def_pb2 import (
+    Node as ChakraNode,
+    GlobalMetadata,
+    AttributeProto as ChakraAttr,
+    COMP_NODE,
+    COMM_COLL_NODE,
+    ALL_REDUCE,
+)
+
+def compute_node(node_id: int, duration_micros: int, stream: int) -> ChakraNode:
+    node = ChakraNode()
+    node.id = node_id
+    node.name = f"Compute{node_id}"
+    node.type = COMP_NODE
+    node.duration_micros = duration_micros
+    node.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+    node.attr.append(ChakraAttr(name="stream", int32_val=stream))
+    return node
+
+def all_reduce_node(node_id: int, coll_size: int, stream: int) -> ChakraNode:
+    node = ChakraNode()
+    node.id = node_id
+    node.name = f"All-Reduce{node_id}"
+    node.type = COMM_COLL_NODE
+    node.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+    node.attr.append(ChakraAttr(name="comm_type", int64_val=ALL_REDUCE))
+    node.attr.append(ChakraAttr(name="comm_size", int64_val=coll_size))
+    node.attr.append(ChakraAttr(name="stream", int32_val=stream))
+    return node
+
+def main() -> None:
+    # metadata
+    npus_count = 8  # 8 NPUs
+    coll_size = 1_048_576  # 1 MB
+
+    for npu_id in range(npus_count):
+        # independent compute nodes: 10 us and 10 us pinned to stream 0,
+        # 20 us pinned to stream 1
+        with open(f"compute.{npu_id}.et", "wb") as et:
+            encode_message(et, GlobalMetadata(version="0.0.4"))
+            encode_message(et, compute_node(1, 10, 0))
+            encode_message(et, compute_node(2, 10, 0))
+            encode_message(et, compute_node(3, 20, 1))
+
+        # independent all-reduces, one on each communication stream
+        with open(f"collectives.{npu_id}.et", "wb") as et:
+            encode_message(et, GlobalMetadata(version="0.0.4"))
+            encode_message(et, all_reduce_node(1, coll_size, 0))
+            encode_message(et, all_reduce_node(2, coll_size, 1))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,56 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+)
+
+# Generate inputs
+(
+echo "[$0] Generating inputs..."
+${SCRIPT_DIR}/inputs/workload/gen.sh
+)
+
+# Run ASTRA-sim on the compute and on the collectives workload
+for workload in compute collectives; do
+(
+echo "[$0] Running ASTRA-sim on ${workload}..."
+${ASTRA_SIM_BIN} \
+    --workload-configuration=${SCRIPT_DIR}/inputs/workload/${workload} \
+    --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+    --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+    --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+    --log-output-path=${SCRIPT_DIR}/outputs/log_${workload}.txt \
+	| tee ${SCRIPT_DIR}/outputs/stdout_${workload}.txt
+)
+done
+
+clean_log() {
+    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //'
+}
+
+# ranks finishing at the same tick may report in any order
+sorted() {
+    LC_ALL=C sort "$1"
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+clean_log < ${SCRIPT_DIR}/outputs/stdout_compute.txt > ${SCRIPT_DIR}/outputs/stdout_compute_clean.txt
+diff <(sorted ${SCRIPT_DIR}/outputs/stdout_compute_clean.txt) <(sorted ${SCRIPT_DIR}/refs/stdout_compute.txt) || (echo "Failed." ; exit 1)
+
+# both collectives of every rank are in flight at once: the busy times of
+# the two communication streams add up to more than the whole run
+sed -nE 's/.*sys\[[0-9]+\] stream occupancy: .*communication ([0-9.]+)% ([0-9.]+)%$/\1 \2/p' \
+    ${SCRIPT_DIR}/outputs/stdout_collectives.txt > ${SCRIPT_DIR}/outputs/comm_occupancy.txt
+awk '$1 > 0 && $2 > 0 && $1 + $2 > 100 { overlapped++ } END { exit overlapped == 8 ? 0 : 1 }' \
+    ${SCRIPT_DIR}/outputs/comm_occupancy.txt || (echo "Failed." ; exit 1)
+)
+
+echo "[$0] Ok."
@@ -0,0 +1,69 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+)
+
+# Run ASTRA-sim
+# (text workloads are read directly, without generating Chakra ETs)
+(
+echo "[$0] Running ASTRA-sim..."
+${ASTRA_SIM_BIN} \
+    --workload-configuration=${SCRIPT_DIR}/inputs/workload/micro_all_reduce.txt \
+    --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+    --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+    --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+    --log-output-path=${SCRIPT_DIR}/outputs/log.txt \
+	| tee ${SCRIPT_DIR}/outputs/stdout.txt
+)
+
+# Convert the DATA workload to Chakra ETs, and run both the ETs and the
+# text workload
+(
+echo "[$0] Converting the DATA workload to Chakra ETs..."
+mkdir -p ${SCRIPT_DIR}/outputs/data_parallel
+chakra_converter Text \
+    --input=${SCRIPT_DIR}/inputs/workload/data_parallel.txt \
+    --output=${SCRIPT_DIR}/outputs/data_parallel/data_parallel \
+    --num-npus=8 \
+    --num-passes=1
+)
+
+run_data_parallel() {
+    echo "[$0] Running ASTRA-sim on $1..."
+    ${ASTRA_SIM_BIN} \
+        --workload-configuration=$1 \
+        --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+        --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+        --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+        --log-output-path=${SCRIPT_DIR}/outputs/log.txt \
+        | tee ${SCRIPT_DIR}/outputs/$2
+}
+run_data_parallel ${SCRIPT_DIR}/outputs/data_parallel/data_parallel stdout_data_et.txt
+run_data_parallel ${SCRIPT_DIR}/inputs/workload/data_parallel.txt stdout_data_text.txt
+
+finished() {
+    sed -nE 's/.*(sys\[[0-9]+\] finished,.*)/\1/p' | sort
+}
+
+clean_log() {
+    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //'
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+clean_log < ${SCRIPT_DIR}/outputs/stdout.txt > ${SCRIPT_DIR}/outputs/stdout_clean.txt
+diff ${SCRIPT_DIR}/outputs/stdout_clean.txt ${SCRIPT_DIR}/refs/stdout.txt || (echo "Failed." ; exit 1)
+finished < ${SCRIPT_DIR}/outputs/stdout_data_et.txt > ${SCRIPT_DIR}/outputs/finished_et.txt
+finished < ${SCRIPT_DIR}/outputs/stdout_data_text.txt > ${SCRIPT_DIR}/outputs/finished_text.txt
+diff ${SCRIPT_DIR}/outputs/finished_text.txt ${SCRIPT_DIR}/outputs/finished_et.txt || (echo "Failed." ; exit 1)
+)
+
+echo "[$0] Ok."
@@ -0,0 +1,60 @@
+import os
+
+from chakra.src.third_party.utils.protolib import encodeMessage as encode_message
+from chakra.schema.protobuf.et_def_pb2 import (
+    Node as ChakraNode,
+    GlobalMetadata,
+    AttributeProto as ChakraAttr,
+    COMP_NODE,
+    COMM_SEND_NODE,
+    COMM_RECV_NODE,
+)
+
+def main() -> None:
+    # metadata
+    npus_count = 2  # 2 NPUs
+    msg_size = 1_048_576  # 1 MB
+
+    for npu_id in range(npus_count):
+        peer = 1 - npu_id
+        output_filename = f"chakra_trace.{npu_id}.et"
+        with open(output_filename, "wb") as et:
+            # Chakra Metadata
+            encode_message(et, GlobalMetadata(version="0.0.4"))
+
+            # receive from the peer, whose send is the last node of its trace
+            recv = ChakraNode()
+            recv.id = 1
+            recv.name = "Recv"
+            recv.type = COMM_RECV_NODE
+            recv.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+            recv.attr.append(ChakraAttr(name="comm_src", int32_val=peer))
+            recv.attr.append(ChakraAttr(name="comm_dst", int32_val=npu_id))
+            recv.attr.append(ChakraAttr(name="comm_size", int64_val=msg_size))
+            recv.attr.append(ChakraAttr(name="comm_tag", int32_val=peer))
+            encode_message(et, recv)
+
+            # waits for the send, which is later in the trace
+            comp = ChakraNode()
+            comp.id = 2
+            comp.name = "Compute"
+            comp.type = COMP_NODE
+            comp.duration_micros = 10
+            comp.data_deps.append(3)
+            comp.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+            encode_message(et, comp)
+
+            # send to the peer, beyond a window of 2 nodes
+            send = ChakraNode()
+            send.id = 3
+            send.name = "Send"
+            send.type = COMM_SEND_NODE
+            send.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+            send.attr.append(ChakraAttr(name="comm_src", int32_val=npu_id))
+            send.attr.append(ChakraAttr(name="comm_dst", int32_val=peer))
+            send.attr.append(ChakraAttr(name="comm_size", int64_val=msg_size))
+            send.attr.append(ChakraAttr(name="comm_tag", int32_val=npu_id))
+            encode_message(et, send)
+
+if __name__ == "__main__":
+    main()
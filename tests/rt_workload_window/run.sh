@@ -0,0 +1,42 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+)
+
+# Generate inputs
+(
+echo "[$0] Generating inputs..."
+${SCRIPT_DIR}/inputs/workload/gen.sh
+)
+
+# Run ASTRA-sim
+(
+echo "[$0] Running ASTRA-sim..."
+${ASTRA_SIM_BIN} \
+    --workload-configuration=${SCRIPT_DIR}/inputs/workload/chakra_trace \
+    --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+    --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+    --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+    --log-output-path=${SCRIPT_DIR}/outputs/log.txt \
+	| tee ${SCRIPT_DIR}/outputs/stdout.txt
+)
+
+finished_ranks() {
+    sed -nE 's/.*(sys\[[0-9]+\] finished).*/\1/p' | sort
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+finished_ranks < ${SCRIPT_DIR}/outputs/stdout.txt > ${SCRIPT_DIR}/outputs/finished.txt
+diff ${SCRIPT_DIR}/outputs/finished.txt ${SCRIPT_DIR}/refs/finished.txt || (echo "Failed." ; exit 1)
+)
+
+echo "[$0] Ok."
@@ -9,4 +9,16 @@ echo "[$0] Running all regression tests..."
 echo "[$0] Running rt_template..."
 ${SCRIPT_DIR}/rt_template/run.sh || (echo "Failed." ; exit 1)
 
+echo "[$0] Running rt_meshxy_all_reduce..."
+${SCRIPT_DIR}/rt_meshxy_all_reduce/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_workload_window..."
+${SCRIPT_DIR}/rt_workload_window/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_text_workload..."
+${SCRIPT_DIR}/rt_text_workload/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_multi_stream..."
+${SCRIPT_DIR}/rt_multi_stream/run.sh || (echo "Failed." ; exit 1)
+
 echo "[$0] Finished all regression tests."
\ No newline at end of file
@@ -0,0 +1,82 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Scaling benchmark of the stream scheduler (Sys::ready_list and the
+# active_Streams queues) in the number of chunks. Runs one all-reduce split
+# into more and more chunks ("preferred-dataset-splits") and prints the wall
+# time of each run. A second binary, e.g. a build of an older commit, is run
+# alongside for comparison.
+#
+# Usage: bench_chunk_scaling.sh [astra-sim binary] [baseline binary]
+# The binary defaults to the congestion-aware analytical build.
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/.."
+
+# paths
+ASTRA_SIM="${1:-${PROJECT_DIR:?}/build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware}"
+BASELINE="$2"
+SPLITS=(16 64 256 1024 4096 16384)
+BENCH_DIR=$(mktemp -d)
+trap 'rm -rf "${BENCH_DIR:?}"' EXIT
+
+# one 1 GB all-reduce
+cat > "${BENCH_DIR:?}/workload.txt" <<EOF
+MICRO
+1
+layer0 -1 5 NONE 0 5 NONE 0 5 ALLREDUCE 1073741824 5
+EOF
+
+cat > "${BENCH_DIR:?}/network.yml" <<EOF
+topology: [ Ring ]
+npus_count: [ 8 ]
+bandwidth: [ 50.0 ]  # GB/s
+latency: [ 500.0 ]  # ns
+EOF
+
+echo '{ "memory-type": "NO_MEMORY_EXPANSION" }' > "${BENCH_DIR:?}/remote_memory.json"
+
+run() {
+    local start end
+    start=$(date +%s%N)
+    "$1" \
+        --workload-configuration="${BENCH_DIR:?}/workload.txt" \
+        --system-configuration="${BENCH_DIR:?}/system.json" \
+        --remote-memory-configuration="${BENCH_DIR:?}/remote_memory.json" \
+        --network-configuration="${BENCH_DIR:?}/network.yml" \
+        --log-output-path="${BENCH_DIR:?}/log.txt" > /dev/null
+    end=$(date +%s%N)
+    awk -v ns=$((end - start)) 'BEGIN { printf "%.3f", ns / 1e9 }'
+}
+
+printf "%8s %16s %16s\n" "chunks" "wall (s)" "baseline (s)"
+for splits in "${SPLITS[@]}"; do
+    # every chunk may be in flight, so that the queues grow with the splits
+    cat > "${BENCH_DIR:?}/system.json" <<EOF
+{
+    "scheduling-policy": "FIFO",
+    "endpoint-delay": 10,
+    "active-chunks-per-dimension": ${splits},
+    "preferred-dataset-splits": ${splits},
+    "all-reduce-implementation": ["ring"],
+    "all-gather-implementation": ["ring"],
+    "reduce-scatter-implementation": ["ring"],
+    "all-to-all-implementation": ["ring"],
+    "collective-optimization": "baseline",
+    "local-mem-bw": 1600,
+    "boost-mode": 0
+}
+EOF
+    wall=$(run "${ASTRA_SIM:?}")
+    baseline="-"
+    if [ -n "${BASELINE}" ]; then
+        baseline=$(run "${BASELINE}")
+    fi
+    printf "%8d %16s %16s\n" "${splits}" "${wall}" "${baseline}"
+done
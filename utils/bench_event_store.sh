@@ -0,0 +1,81 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Benchmark of the per-Sys event store. Runs one workload with
+# "event-queue": "map" and then "calendar", and prints the events
+# dispatched per second of the simulation loop, as reported with
+# "report-profile".
+#
+# Usage: bench_event_store.sh [astra-sim binary] [dataset splits...]
+# The binary defaults to the congestion-aware analytical build.
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/.."
+
+# paths
+ASTRA_SIM="${1:-${PROJECT_DIR:?}/build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware}"
+shift || true
+SPLITS=("$@")
+if [ ${#SPLITS[@]} -eq 0 ]; then
+    SPLITS=(16 256 4096)
+fi
+BENCH_DIR=$(mktemp -d)
+trap 'rm -rf "${BENCH_DIR:?}"' EXIT
+
+# 8 layers, each with an all-reduce of 16 MB
+{
+    echo "MICRO"
+    echo "8"
+    for i in $(seq 0 7); do
+        echo "layer${i} -1 5 NONE 0 5 NONE 0 5 ALLREDUCE 16777216 5"
+    done
+} > "${BENCH_DIR:?}/workload.txt"
+
+cat > "${BENCH_DIR:?}/network.yml" <<EOT
+topology: [ Ring ]
+npus_count: [ 16 ]
+bandwidth: [ 50.0 ]  # GB/s
+latency: [ 500.0 ]  # ns
+EOT
+
+echo '{ "memory-type": "NO_MEMORY_EXPANSION" }' > "${BENCH_DIR:?}/remote_memory.json"
+
+run() {
+    cat > "${BENCH_DIR:?}/system.json" <<EOT
+{
+    "scheduling-policy": "LIFO",
+    "endpoint-delay": 10,
+    "active-chunks-per-dimension": $2,
+    "preferred-dataset-splits": $2,
+    "all-reduce-implementation": ["ring"],
+    "all-gather-implementation": ["ring"],
+    "reduce-scatter-implementation": ["ring"],
+    "all-to-all-implementation": ["ring"],
+    "collective-optimization": "baseline",
+    "local-mem-bw": 1600,
+    "boost-mode": 0,
+    "event-queue": "$1",
+    "report-profile": 1
+}
+EOT
+    "${ASTRA_SIM:?}" \
+        --workload-configuration="${BENCH_DIR:?}/workload.txt" \
+        --system-configuration="${BENCH_DIR:?}/system.json" \
+        --remote-memory-configuration="${BENCH_DIR:?}/remote_memory.json" \
+        --network-configuration="${BENCH_DIR:?}/network.yml" \
+        --log-output-path="${BENCH_DIR:?}/log.txt" \
+        | sed -nE 's/.*events: ([0-9]+) dispatched, .* ([0-9]+) events\/sec$/\1 \2/p'
+}
+
+printf "%8s %12s %16s %16s\n" "chunks" "events" "map (ev/s)" "calendar (ev/s)"
+for splits in "${SPLITS[@]}"; do
+    read -r events map <<< "$(run map "${splits}")"
+    read -r _ calendar <<< "$(run calendar "${splits}")"
+    printf "%8d %12s %16s %16s\n" "${splits}" "${events}" "${map}" "${calendar}"
+done
@@ -0,0 +1,95 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Scaling benchmark of the cross-rank schedule barrier (Sys::ask_for_schedule).
+# Runs the same all-reduce workload on 64 to 16K NPUs with
+# "synchronized-scheduling" on and off, and prints the wall time of each run.
+#
+# Usage: bench_schedule_barrier.sh [astra-sim binary] [npu counts...]
+# The binary defaults to the congestion-unaware analytical build.
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/.."
+
+# paths
+ASTRA_SIM="${1:-${PROJECT_DIR:?}/build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Unaware}"
+shift || true
+NPU_COUNTS=("$@")
+if [ ${#NPU_COUNTS[@]} -eq 0 ]; then
+    NPU_COUNTS=(64 256 1024 4096 16384)
+fi
+BENCH_DIR=$(mktemp -d)
+trap 'rm -rf "${BENCH_DIR:?}"' EXIT
+
+# 8 layers, each with an all-reduce of 64 KB
+{
+    echo "MICRO"
+    echo "8"
+    for i in $(seq 0 7); do
+        echo "layer${i} -1 5 NONE 0 5 NONE 0 5 ALLREDUCE 65536 5"
+    done
+} > "${BENCH_DIR:?}/workload.txt"
+
+echo '{ "memory-type": "NO_MEMORY_EXPANSION" }' > "${BENCH_DIR:?}/remote_memory.json"
+
+write_system() {
+    cat > "$1" <<EOF
+{
+    "scheduling-policy": "LIFO",
+    "endpoint-delay": 10,
+    "active-chunks-per-dimension": 1,
+    "preferred-dataset-splits": 4,
+    "all-reduce-implementation": ["ring", "ring"],
+    "all-gather-implementation": ["ring", "ring"],
+    "reduce-scatter-implementation": ["ring", "ring"],
+    "all-to-all-implementation": ["ring", "ring"],
+    "collective-optimization": "baseline",
+    "local-mem-bw": 1600,
+    "boost-mode": 0,
+    "synchronized-scheduling": $2
+}
+EOF
+}
+write_system "${BENCH_DIR:?}/system_sync.json" 1
+write_system "${BENCH_DIR:?}/system_nosync.json" 0
+
+run() {
+    local start end
+    start=$(date +%s%N)
+    "${ASTRA_SIM:?}" \
+        --workload-configuration="${BENCH_DIR:?}/workload.txt" \
+        --system-configuration="$1" \
+        --remote-memory-configuration="${BENCH_DIR:?}/remote_memory.json" \
+        --network-configuration="$2" \
+        --log-output-path="${BENCH_DIR:?}/log.txt" > /dev/null
+    end=$(date +%s%N)
+    awk -v ns=$((end - start)) 'BEGIN { printf "%.3f", ns / 1e9 }'
+}
+
+printf "%8s %16s %16s\n" "npus" "sync wall (s)" "no-sync wall (s)"
+for npus in "${NPU_COUNTS[@]}"; do
+    # as square a 2D ring as the count allows
+    x=1
+    while [ $(((x + 1) * (x + 1))) -le "${npus}" ]; do
+        x=$((x + 1))
+    done
+    while [ $((npus % x)) -ne 0 ]; do
+        x=$((x - 1))
+    done
+    y=$((npus / x))
+    cat > "${BENCH_DIR:?}/network.yml" <<EOF
+topology: [ Ring, Ring ]
+npus_count: [ ${x}, ${y} ]
+bandwidth: [ 50.0, 50.0 ]  # GB/s
+latency: [ 500.0, 500.0 ]  # ns
+EOF
+    sync=$(run "${BENCH_DIR:?}/system_sync.json" "${BENCH_DIR:?}/network.yml")
+    nosync=$(run "${BENCH_DIR:?}/system_nosync.json" "${BENCH_DIR:?}/network.yml")
+    printf "%8d %16.3f %16.3f\n" "${npus}" "${sync}" "${nosync}"
+done